@@ -0,0 +1,41 @@
+#ifndef ANALYTIC_HPP
+#define ANALYTIC_HPP
+
+#include "Integrator.hpp"
+
+// Closed-form solution of m x'' + c x' + k x = F cos(wd t) for given initial
+// conditions: the homogeneous part for the damping regime plus the steady-state
+// driven response. Solving is O(1) and so is evaluating at any t, so seeking
+// costs the same as for the undamped model.
+
+enum Regime {
+    UNDAMPED,
+    UNDERDAMPED,
+    CRITICAL,
+    OVERDAMPED,
+    REGIME_COUNT
+};
+
+struct Solution {
+    int regime;
+    double t0;
+    double gamma;   // decay rate c / 2m
+    double w;       // damped angular frequency, or sqrt(gamma^2 - w0^2) when overdamped
+    double A;
+    double B;
+
+    // Steady state P cos(wd t) + Q sin(wd t); R t sin(wd t) at undamped resonance.
+    double wd;
+    double P;
+    double Q;
+    double R;
+};
+
+extern const char* regimeNames[REGIME_COUNT];
+
+bool hasClosedForm(const struct Model* m);
+void solveAnalytic(struct Solution* s, const struct Model* m, double x0, double v0, double t0);
+void evaluateSolution(const struct Solution* s, double t, double* x, double* v);
+void sampleSolution(const struct Solution* s, double t0, double dt, float* out, int n);
+
+#endif // ANALYTIC_HPP
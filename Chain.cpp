@@ -0,0 +1,273 @@
+#include "Chain.hpp"
+#include "SinCos.hpp"
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+void initChain(struct Chain* c, int n, double mass, double k, bool fixedLeft, bool fixedRight) {
+    c->n = n;
+    c->mass.assign(n, mass);
+    c->k.assign(n + 1, k);
+    c->fixedLeft = fixedLeft;
+    c->fixedRight = fixedRight;
+    c->x0.assign(n, 0);
+    c->v0.assign(n, 0);
+    c->dirty = true;
+    c->projected = false;
+    c->modeLimit = n;
+    c->x.assign(n, 0);
+    c->phase.assign(n, 0);
+    c->sinPhase.assign(n, 0);
+    c->cosPhase.assign(n, 0);
+}
+
+void setChainMass(struct Chain* c, int i, double mass) {
+    c->mass[i] = mass;
+    c->dirty = true;
+}
+
+void setChainLink(struct Chain* c, int i, double k) {
+    c->k[i] = k;
+    c->dirty = true;
+}
+
+void setChainEnds(struct Chain* c, bool fixedLeft, bool fixedRight) {
+    c->fixedLeft = fixedLeft;
+    c->fixedRight = fixedRight;
+    c->dirty = true;
+}
+
+void setChainInitial(struct Chain* c, const double* x0, const double* v0) {
+    c->x0.assign(x0, x0 + c->n);
+    c->v0.assign(v0, v0 + c->n);
+    c->projected = false;
+}
+
+static double linkK(const struct Chain* c, int i) {
+    if (i == 0 && !c->fixedLeft) { return 0; }
+    if (i == c->n && !c->fixedRight) { return 0; }
+    return c->k[i];
+}
+
+// Eigenvalues of the symmetric tridiagonal matrix (d, e) by implicit QL;
+// e[i] couples rows i and i + 1 and is destroyed.
+static void tridiagonalEigenvalues(std::vector<double>& d, std::vector<double>& e) {
+    int n = d.size();
+    e.resize(n);
+    e[n - 1] = 0;
+
+    for (int l = 0; l < n; l++) {
+        int m;
+        for (int iter = 0; iter < 60; iter++) {
+            for (m = l; m < n - 1; m++) {
+                double dd = fabs(d[m]) + fabs(d[m + 1]);
+                if (fabs(e[m]) <= DBL_EPSILON * dd) { break; }
+            }
+            if (m == l) { break; }
+
+            double g = (d[l + 1] - d[l]) / (2 * e[l]);
+            double r = hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + copysign(r, g));
+            double s = 1, cs = 1, p = 0;
+            int i;
+            for (i = m - 1; i >= l; i--) {
+                double f = s * e[i];
+                double b = cs * e[i];
+                r = hypot(f, g);
+                e[i + 1] = r;
+                if (r == 0) {
+                    d[i + 1] -= p;
+                    e[m] = 0;
+                    break;
+                }
+                s = f / r;
+                cs = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2 * cs * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = cs * r - b;
+            }
+            if (r == 0 && i >= l) { continue; }
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0;
+        }
+    }
+    std::sort(d.begin(), d.end());
+}
+
+// LU factorization with partial pivoting of a tridiagonal matrix, as LAPACK
+// dgttrf: dl, d, du are the sub, main and super diagonals, du2 receives the
+// fill-in. Zero pivots are nudged to tiny so inverse iteration can proceed.
+static void tridiagonalFactor(int n, double* dl, double* d, double* du, double* du2, char* swapped, double tiny) {
+    for (int i = 0; i < n - 1; i++) {
+        if (fabs(d[i]) >= fabs(dl[i])) {
+            if (d[i] == 0) { d[i] = tiny; }
+            double f = dl[i] / d[i];
+            dl[i] = f;
+            d[i + 1] -= f * du[i];
+            if (i < n - 2) { du2[i] = 0; }
+            swapped[i] = false;
+        } else {
+            double f = d[i] / dl[i];
+            d[i] = dl[i];
+            dl[i] = f;
+            double tmp = du[i];
+            du[i] = d[i + 1];
+            d[i + 1] = tmp - f * d[i + 1];
+            if (i < n - 2) {
+                du2[i] = du[i + 1];
+                du[i + 1] = - f * du[i + 1];
+            }
+            swapped[i] = true;
+        }
+    }
+    if (d[n - 1] == 0) { d[n - 1] = tiny; }
+}
+
+static void tridiagonalSolve(int n, const double* dl, const double* d, const double* du, const double* du2, const char* swapped, double* b) {
+    for (int i = 0; i < n - 1; i++) {
+        if (!swapped[i]) {
+            b[i + 1] -= dl[i] * b[i];
+        } else {
+            double tmp = b[i];
+            b[i] = b[i + 1];
+            b[i + 1] = tmp - dl[i] * b[i];
+        }
+    }
+    b[n - 1] /= d[n - 1];
+    if (n > 1) { b[n - 2] = (b[n - 2] - du[n - 2] * b[n - 1]) / d[n - 2]; }
+    for (int i = n - 3; i >= 0; i--) {
+        b[i] = (b[i] - du[i] * b[i + 1] - du2[i] * b[i + 2]) / d[i];
+    }
+}
+
+static void normalize(double* u, int n) {
+    double s = 0;
+    for (int i = 0; i < n; i++) { s += u[i] * u[i]; }
+    s = 1 / sqrt(s);
+    for (int i = 0; i < n; i++) { u[i] *= s; }
+}
+
+static void decompose(struct Chain* c) {
+    int n = c->n;
+    std::vector<double> invSqrtM(n);
+    std::vector<double> d(n), e(n);
+    for (int i = 0; i < n; i++) {
+        invSqrtM[i] = 1 / sqrt(c->mass[i]);
+    }
+    // M^{-1/2} K M^{-1/2}, symmetric tridiagonal.
+    for (int i = 0; i < n; i++) {
+        d[i] = (linkK(c, i) + linkK(c, i + 1)) * invSqrtM[i] * invSqrtM[i];
+        e[i] = (i < n - 1) ? - c->k[i + 1] * invSqrtM[i] * invSqrtM[i + 1] : 0;
+    }
+    std::vector<double> diag = d, off = e;
+
+    std::vector<double> lambda = d;
+    tridiagonalEigenvalues(lambda, e);
+
+    double norm = 0;
+    for (int i = 0; i < n; i++) {
+        norm = fmax(norm, fabs(diag[i]) + 2 * fabs(off[i]));
+    }
+    double tiny = DBL_EPSILON * norm;
+    double cluster = sqrt(DBL_EPSILON) * norm;
+
+    c->omega.resize(n);
+    c->modes.resize((size_t) n * n);
+    std::vector<double> dl(n), dd(n), du(n), du2(n), u(n);
+    std::vector<char> swapped(n);
+    int clusterStart = 0;
+
+    for (int j = 0; j < n; j++) {
+        double lj = lambda[j];
+        c->omega[j] = sqrt(fmax(lj, 0.0));
+
+        // Slightly separate coincident eigenvalues so inverse iteration
+        // converges to different vectors.
+        if (j > 0 && lj - lambda[j - 1] < 10 * tiny) {
+            lj = lambda[j - 1] + 10 * tiny;
+            lambda[j] = lj;
+        }
+        if (j == 0 || lj - lambda[j - 1] > cluster) {
+            clusterStart = j;
+        }
+
+        for (int i = 0; i < n; i++) {
+            dd[i] = diag[i] - lj;
+            dl[i] = off[i];
+            du[i] = off[i];
+            u[i] = 1 + 1e-3 * ((i * 7919 + j * 104729) % 1000);
+        }
+        tridiagonalFactor(n, dl.data(), dd.data(), du.data(), du2.data(), swapped.data(), tiny);
+
+        for (int it = 0; it < 2; it++) {
+            tridiagonalSolve(n, dl.data(), dd.data(), du.data(), du2.data(), swapped.data(), u.data());
+            // Re-orthogonalize against the earlier members of a close cluster.
+            for (int p = clusterStart; p < j; p++) {
+                const float* row = &c->modes[(size_t) p * n];
+                double dot = 0;
+                for (int i = 0; i < n; i++) { dot += u[i] * row[i] / invSqrtM[i]; }
+                for (int i = 0; i < n; i++) { u[i] -= dot * row[i] / invSqrtM[i]; }
+            }
+            normalize(u.data(), n);
+        }
+
+        float* row = &c->modes[(size_t) j * n];
+        for (int i = 0; i < n; i++) {
+            row[i] = u[i] * invSqrtM[i];
+        }
+    }
+
+    c->dirty = false;
+    c->projected = false;
+}
+
+// Modal initial conditions: q = phi^T M x0, q' = phi^T M v0.
+static void project(struct Chain* c) {
+    int n = c->n;
+    c->q0.assign(n, 0);
+    c->qd0.assign(n, 0);
+    for (int j = 0; j < n; j++) {
+        const float* row = &c->modes[(size_t) j * n];
+        double q = 0, qd = 0;
+        for (int i = 0; i < n; i++) {
+            q += row[i] * c->mass[i] * c->x0[i];
+            qd += row[i] * c->mass[i] * c->v0[i];
+        }
+        c->q0[j] = q;
+        c->qd0[j] = qd;
+    }
+    c->projected = true;
+}
+
+void updateChain(struct Chain* c) {
+    if (c->dirty) { decompose(c); }
+    if (!c->projected) { project(c); }
+}
+
+void evaluateChain(struct Chain* c, double t) {
+    updateChain(c);
+    int n = c->n;
+    int modes = std::min(c->modeLimit, n);
+
+    float* s = c->sinPhase.data();
+    float* cs = c->cosPhase.data();
+    for (int j = 0; j < modes; j++) {
+        c->phase[j] = fmod(c->omega[j] * t, 2 * M_PI);
+    }
+    sinCosArray(c->phase.data(), s, cs, modes);
+
+    std::fill(c->x.begin(), c->x.end(), 0.f);
+    float* x = c->x.data();
+    for (int j = 0; j < modes; j++) {
+        // Rigid-body modes of a free-free chain drift instead of oscillating.
+        float q = (c->omega[j] > 1e-9) ? c->q0[j] * cs[j] + c->qd0[j] / c->omega[j] * s[j]
+                                       : c->q0[j] + c->qd0[j] * t;
+        const float* row = &c->modes[(size_t) j * n];
+        for (int i = 0; i < n; i++) {
+            x[i] += q * row[i];
+        }
+    }
+}
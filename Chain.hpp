@@ -0,0 +1,49 @@
+#ifndef CHAIN_HPP
+#define CHAIN_HPP
+
+#include <vector>
+
+// N masses joined by springs, optionally tied to walls at either end.
+//
+// Link i joins mass i - 1 to mass i, so links 0 and n are the wall links and
+// only count when that end is fixed. The stiffness matrix is tridiagonal; it
+// is decomposed into normal modes once per mass/k edit (implicit QL for the
+// frequencies, inverse iteration for the shapes, both O(N^2)), and every
+// evaluation afterwards is a superposition of the cached modes.
+struct Chain {
+    int n;
+    std::vector<double> mass;
+    std::vector<double> k;
+    bool fixedLeft;
+    bool fixedRight;
+
+    std::vector<double> x0;
+    std::vector<double> v0;
+
+    // Cached decomposition: omega[j] and mass-normalized shape j stored as
+    // row j of modes, so that x = sum_j q_j(t) * modes[j].
+    bool dirty;
+    bool projected;
+    std::vector<double> omega;
+    std::vector<float> modes;
+    std::vector<double> q0;
+    std::vector<double> qd0;
+
+    int modeLimit;
+    std::vector<float> x;
+
+    // evaluateChain() scratch, one entry per mode.
+    std::vector<float> phase;
+    std::vector<float> sinPhase;
+    std::vector<float> cosPhase;
+};
+
+void initChain(struct Chain* c, int n, double mass, double k, bool fixedLeft, bool fixedRight);
+void setChainMass(struct Chain* c, int i, double mass);
+void setChainLink(struct Chain* c, int i, double k);
+void setChainEnds(struct Chain* c, bool fixedLeft, bool fixedRight);
+void setChainInitial(struct Chain* c, const double* x0, const double* v0);
+void updateChain(struct Chain* c);
+void evaluateChain(struct Chain* c, double t);
+
+#endif // CHAIN_HPP
@@ -19,6 +19,10 @@
 /*!
  @file sftools/Chronometer.hpp
  @brief Defines Chronometer
+
+ Altered for MHS: the chronometer is templated on its clock source
+ (BasicChronometer) so it can be driven by a VirtualClock; Chronometer is
+ the original sf::Clock-driven type.
  */
 
 #ifndef __SFTOOLS_BASE_CHRONOMETER_HPP__
@@ -33,10 +37,13 @@
 namespace sftools
 {
     /*!
-     @class Chronometer
+     @class BasicChronometer
      @brief Provide functionalities of a chronometer, aka stop watch
+
+     @tparam Clock Clock source, with sf::Clock's getElapsedTime and restart
      */
-    class Chronometer
+    template <typename Clock>
+    class BasicChronometer
     {
     public:
         /*!
@@ -44,7 +51,7 @@ namespace sftools
          
          @param initialTime Initial time elapsed
          */
-        Chronometer(sf::Time initialTime = sf::Time::Zero)
+        BasicChronometer(sf::Time initialTime = sf::Time::Zero)
         {
             reset();
             add(initialTime);
@@ -173,11 +180,26 @@ namespace sftools
             return getElapsedTime();
         }
 
+        /*!
+         @brief Give access to the underlying clock source
+         @return Clock
+         */
+        Clock& getClock()
+        {
+            return m_clock;
+        }
+
     private:
         enum { STOPPED, RUNNING, PAUSED } m_state;  //!< state
         sf::Time m_time;                            //!< time counter
-        sf::Clock m_clock;                          //!< clock
+        Clock m_clock;                              //!< clock
     };
+
+    /*!
+     @typedef Chronometer
+     @brief Chronometer driven by the wall clock
+     */
+    typedef BasicChronometer<sf::Clock> Chronometer;
 }
 
 
@@ -0,0 +1,191 @@
+#include "DormandPrince.hpp"
+#include <cmath>
+
+const char* eventNames[EVENT_TYPE_COUNT] = {
+    "zero crossing",
+    "peak",
+    "equilibrium"
+};
+
+// Butcher tableau, embedded error weights and dense output weights from
+// Hairer, Norsett & Wanner, "Solving Ordinary Differential Equations I".
+static const double c2 = 1.0 / 5, c3 = 3.0 / 10, c4 = 4.0 / 5, c5 = 8.0 / 9;
+static const double a21 = 1.0 / 5;
+static const double a31 = 3.0 / 40, a32 = 9.0 / 40;
+static const double a41 = 44.0 / 45, a42 = -56.0 / 15, a43 = 32.0 / 9;
+static const double a51 = 19372.0 / 6561, a52 = -25360.0 / 2187, a53 = 64448.0 / 6561, a54 = -212.0 / 729;
+static const double a61 = 9017.0 / 3168, a62 = -355.0 / 33, a63 = 46732.0 / 5247, a64 = 49.0 / 176, a65 = -5103.0 / 18656;
+static const double a71 = 35.0 / 384, a73 = 500.0 / 1113, a74 = 125.0 / 192, a75 = -2187.0 / 6784, a76 = 11.0 / 84;
+static const double e1 = 71.0 / 57600, e3 = -71.0 / 16695, e4 = 71.0 / 1920, e5 = -17253.0 / 339200, e6 = 22.0 / 525, e7 = -1.0 / 40;
+static const double d1 = -12715105075.0 / 11282082432, d3 = 87487479700.0 / 32700410799, d4 = -10690763975.0 / 1880347072,
+                    d5 = 701980252875.0 / 199316789632, d6 = -1453857185.0 / 822651844, d7 = 69997945.0 / 29380423;
+
+static void deriv(const struct Model* m, double t, const double* y, double* dy) {
+    dy[0] = y[1];
+    dy[1] = accel(m, y[0], y[1], t);
+}
+
+static double amplitude(const struct Model* m, double x, double v) {
+    return sqrt(x * x + v * v * m->mass / m->k);
+}
+
+// Event functions; an event fires where g changes sign.
+static double eventFunction(const struct DormandPrince* d, const struct Model* m, int type, double x, double v) {
+    switch (type) {
+        case ZERO_CROSSING: return x;
+        case PEAK: return v;
+        default: return amplitude(m, x, v) - d->band;
+    }
+}
+
+// Illinois-modified regula falsi on the dense output of the last step.
+static double locateEvent(const struct DormandPrince* d, const struct Model* m, int type, double ta, double ga, double tb, double gb) {
+    int side = 0;
+    for (int i = 0; i < 100 && tb - ta > EVENT_TOLERANCE * (1 + fabs(tb)); i++) {
+        double tc = (ta * gb - tb * ga) / (gb - ga);
+        if (!(tc > ta && tc < tb)) { tc = 0.5 * (ta + tb); }
+
+        double x, v;
+        dormandPrinceDense(d, tc, &x, &v);
+        double gc = eventFunction(d, m, type, x, v);
+
+        if ((gc > 0) == (gb > 0)) {
+            tb = tc;
+            gb = gc;
+            if (side == -1) { ga *= 0.5; }
+            side = -1;
+        } else {
+            ta = tc;
+            ga = gc;
+            if (side == 1) { gb *= 0.5; }
+            side = 1;
+        }
+    }
+    return (fabs(ga) < fabs(gb)) ? ta : tb;
+}
+
+static void detectEvents(struct DormandPrince* d, const struct Model* m, const double* y0) {
+    double t0 = d->t - d->hLast;
+    for (int type = 0; type < EVENT_TYPE_COUNT; type++) {
+        double g0 = eventFunction(d, m, type, y0[0], y0[1]);
+        double g1 = eventFunction(d, m, type, d->y[0], d->y[1]);
+        if ((g0 < 0) == (g1 < 0) || g0 == 0) { continue; }
+        // The equilibrium band only counts when the motion settles into it.
+        if (type == EQUILIBRIUM && g1 > 0) { continue; }
+
+        struct Event ev;
+        ev.type = type;
+        ev.direction = (g1 > g0) ? 1 : -1;
+        ev.t = locateEvent(d, m, type, t0, g0, d->t, g1);
+        dormandPrinceDense(d, ev.t, &ev.x, &ev.v);
+        d->events.push_back(ev);
+    }
+}
+
+void initDormandPrince(struct DormandPrince* d, const struct Model* m, const struct Oscillation* s, double rtol, double atol, double band) {
+    d->rtol = rtol;
+    d->atol = atol;
+    d->band = band;
+    d->t = s->t;
+    d->y[0] = s->x;
+    d->y[1] = s->v;
+    deriv(m, d->t, d->y, d->k1);
+
+    // Initial guess from the natural period; the controller corrects it.
+    d->h = 0.01 * 2 * M_PI * sqrt(m->mass / m->k);
+    if (!(d->h > 0) || std::isinf(d->h)) { d->h = 1e-3; }
+
+    d->hLast = 0;
+    for (int i = 0; i < 5; i++) {
+        d->cont[i][0] = (i == 0) ? d->y[0] : 0;
+        d->cont[i][1] = (i == 0) ? d->y[1] : 0;
+    }
+    d->steps = 0;
+    d->rejected = 0;
+    d->events.clear();
+}
+
+void dormandPrinceStep(struct DormandPrince* d, const struct Model* m) {
+    double k2[2], k3[2], k4[2], k5[2], k6[2], k7[2];
+    double y1[2], yt[2];
+    const double* k1 = d->k1;
+    double t = d->t;
+    double* y = d->y;
+
+    for (;;) {
+        double h = d->h;
+
+        for (int i = 0; i < 2; i++) yt[i] = y[i] + h * a21 * k1[i];
+        deriv(m, t + c2 * h, yt, k2);
+        for (int i = 0; i < 2; i++) yt[i] = y[i] + h * (a31 * k1[i] + a32 * k2[i]);
+        deriv(m, t + c3 * h, yt, k3);
+        for (int i = 0; i < 2; i++) yt[i] = y[i] + h * (a41 * k1[i] + a42 * k2[i] + a43 * k3[i]);
+        deriv(m, t + c4 * h, yt, k4);
+        for (int i = 0; i < 2; i++) yt[i] = y[i] + h * (a51 * k1[i] + a52 * k2[i] + a53 * k3[i] + a54 * k4[i]);
+        deriv(m, t + c5 * h, yt, k5);
+        for (int i = 0; i < 2; i++) yt[i] = y[i] + h * (a61 * k1[i] + a62 * k2[i] + a63 * k3[i] + a64 * k4[i] + a65 * k5[i]);
+        deriv(m, t + h, yt, k6);
+        for (int i = 0; i < 2; i++) y1[i] = y[i] + h * (a71 * k1[i] + a73 * k3[i] + a74 * k4[i] + a75 * k5[i] + a76 * k6[i]);
+        deriv(m, t + h, y1, k7);
+
+        double err = 0;
+        for (int i = 0; i < 2; i++) {
+            double ei = h * (e1 * k1[i] + e3 * k3[i] + e4 * k4[i] + e5 * k5[i] + e6 * k6[i] + e7 * k7[i]);
+            double sc = d->atol + d->rtol * fmax(fabs(y[i]), fabs(y1[i]));
+            err += (ei / sc) * (ei / sc);
+        }
+        err = sqrt(err / 2);
+
+        double factor = (err > 0) ? 0.9 * pow(err, -0.2) : 5;
+        factor = fmin(5, fmax(0.2, factor));
+
+        if (err <= 1) {
+            double y0[2] = { y[0], y[1] };
+            for (int i = 0; i < 2; i++) {
+                double dy = y1[i] - y[i];
+                double bspl = h * k1[i] - dy;
+                d->cont[0][i] = y[i];
+                d->cont[1][i] = dy;
+                d->cont[2][i] = bspl;
+                d->cont[3][i] = dy - h * k7[i] - bspl;
+                d->cont[4][i] = h * (d1 * k1[i] + d3 * k3[i] + d4 * k4[i] + d5 * k5[i] + d6 * k6[i] + d7 * k7[i]);
+                y[i] = y1[i];
+                d->k1[i] = k7[i];
+            }
+            d->t = t + h;
+            d->hLast = h;
+            d->h = h * factor;
+            d->steps++;
+            detectEvents(d, m, y0);
+            return;
+        }
+
+        d->h = h * fmax(0.2, factor);
+        d->rejected++;
+    }
+}
+
+void dormandPrinceDense(const struct DormandPrince* d, double t, double* x, double* v) {
+    if (d->hLast == 0) {
+        *x = d->y[0];
+        *v = d->y[1];
+        return;
+    }
+
+    double theta = (t - (d->t - d->hLast)) / d->hLast;
+    double theta1 = 1 - theta;
+    double out[2];
+    for (int i = 0; i < 2; i++) {
+        out[i] = d->cont[0][i] + theta * (d->cont[1][i] + theta1 * (d->cont[2][i] + theta * (d->cont[3][i] + theta1 * d->cont[4][i])));
+    }
+    *x = out[0];
+    *v = out[1];
+}
+
+void advanceDormandPrince(struct DormandPrince* d, const struct Model* m, double tEnd, struct Oscillation* out) {
+    while (d->t < tEnd) {
+        dormandPrinceStep(d, m);
+    }
+    dormandPrinceDense(d, tEnd, &out->x, &out->v);
+    out->t = tEnd;
+}
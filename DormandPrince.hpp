@@ -0,0 +1,58 @@
+#ifndef DORMANDPRINCE_HPP
+#define DORMANDPRINCE_HPP
+
+#include <vector>
+#include "Integrator.hpp"
+
+// Adaptive Dormand-Prince 5(4) integrator with dense output and event location.
+//
+// The integrator owns its own step grid: advanceDormandPrince() takes accepted
+// steps until the last one reaches past tEnd and then reports the state at
+// tEnd from the continuous extension, so frame-sized queries never shorten the
+// steps. Every accepted step is scanned for events, whose times are located on
+// the dense output to EVENT_TOLERANCE rather than on step or frame boundaries.
+
+#define EVENT_TOLERANCE 1e-12
+
+enum EventType {
+    ZERO_CROSSING,
+    PEAK,
+    EQUILIBRIUM,
+    EVENT_TYPE_COUNT
+};
+
+struct Event {
+    int type;
+    int direction;
+    double t;
+    double x;
+    double v;
+};
+
+struct DormandPrince {
+    double rtol;
+    double atol;
+    double band;
+
+    double t;
+    double h;
+    double y[2];
+    double k1[2];
+
+    // Continuous extension of the last accepted step [t - hLast, t].
+    double hLast;
+    double cont[5][2];
+
+    int steps;
+    int rejected;
+    std::vector<struct Event> events;
+};
+
+extern const char* eventNames[EVENT_TYPE_COUNT];
+
+void initDormandPrince(struct DormandPrince* d, const struct Model* m, const struct Oscillation* s, double rtol, double atol, double band);
+void dormandPrinceStep(struct DormandPrince* d, const struct Model* m);
+void dormandPrinceDense(const struct DormandPrince* d, double t, double* x, double* v);
+void advanceDormandPrince(struct DormandPrince* d, const struct Model* m, double tEnd, struct Oscillation* out);
+
+#endif // DORMANDPRINCE_HPP
@@ -0,0 +1,297 @@
+#include "Engine.hpp"
+#include "Oscillator.hpp"
+#include "Phasor.hpp"
+#include <cmath>
+#include <chrono>
+
+void initParams(struct Params* p) {
+    p->mass = 1;
+    p->Xmax = 1;
+    p->phi = 0;
+    p->damping = 0;
+    p->driveForce = 0;
+    p->driveOmega = 0;
+    p->period = 1;
+    p->omega = 2 * PI / p->period;
+    p->k = p->omega * p->omega * p->mass;
+    p->method = ANALYTIC;
+}
+
+float calcOmega(const struct Params* p) {
+    return sqrtf(p->k / p->mass);
+}
+
+float calcPeriod(const struct Params* p) {
+    return 2 * PI * sqrtf(p->mass / p->k);
+}
+
+void setPeriod(struct Params* p, float period) {
+    p->period = period;
+    p->omega = 2 * PI / period;
+    p->k = p->omega * p->omega * p->mass;
+}
+
+void initEngine(struct Engine* e) {
+    initParams(&e->params);
+    initBank(&e->bank, 1);
+    e->dt = 1.0 / 1000;
+    e->stepCost = 0;
+    e->limited = false;
+    resetState(e, 0);
+}
+
+// Takes effect on the next stepEngine(), which restarts from the closed form.
+void setParams(struct Engine* e, const struct Params* p) {
+    e->params = *p;
+    e->stale = true;
+}
+
+// Everything but the bank, which evaluateState() reads in place rather than
+// copying its arrays for every sample.
+static void captureFields(struct Engine* e, struct Motion* m) {
+    m->params = e->params;
+    m->model = engineModel(e);
+    m->method = activeMethod(e);
+    m->phase = e->phase;
+    m->solution = e->solution;
+    if (m->method == DORMAND_PRINCE) { m->adaptive = e->adaptive; }
+    m->dt = e->dt;
+    m->state = e->state;
+    m->prevState = e->prevState;
+}
+
+void captureMotion(struct Engine* e, struct Motion* m) {
+    captureFields(e, m);
+    m->bank = e->bank;
+}
+
+// Samples every displayed quantity from one instant, with a single sincos.
+// Undamped motion is the Engine's one-slot OscillatorBank, evaluated at the
+// accumulator's phase; damped or driven motion goes through the closed-form
+// Solution. Fixed-step methods blend their last two physics states by how far
+// t is into the next step, so they display one physics step behind but move
+// smoothly at any render rate; Dormand-Prince reads the dense output of its
+// last step, held at the step's end past it.
+static struct State evaluate(const struct Motion* m, const struct OscillatorBank* bank, Tick tick) {
+    struct State st;
+    const struct Params* p = &m->params;
+    double t = secondsFromTicks(tick);
+
+    if (m->method != ANALYTIC || p->damping != 0 || p->driveForce != 0) {
+        double x = m->state.x;
+        double v = m->state.v;
+        if (m->method == ANALYTIC) {
+            evaluateSolution(&m->solution, t, &x, &v);
+        } else if (m->method == DORMAND_PRINCE) {
+            const struct DormandPrince* d = &m->adaptive;
+            double end = (t < d->t) ? t : d->t;
+            dormandPrinceDense(d, (end > d->t - d->hLast) ? end : d->t - d->hLast, &x, &v);
+        } else {
+            double alpha = (t - m->state.t) / m->dt;
+            if (alpha > 1) { alpha = 1; }
+            if (alpha < 0) { alpha = 0; }
+            x = m->prevState.x + (m->state.x - m->prevState.x) * alpha;
+            v = m->prevState.v + (m->state.v - m->prevState.v) * alpha;
+        }
+        st.x = x;
+        st.v = v;
+        st.a = accel(&m->model, x, v, t);
+        st.screenPos = (p->Xmax > 4) ? st.x * 200 / p->Xmax : st.x * 50;
+        return st;
+    }
+
+    evaluateOscillatorPhase(bank, 0, phaseAt(&m->phase, tick), &st.x, &st.v, &st.a);
+    st.screenPos = (p->Xmax > 4) ? st.x * 200 / p->Xmax : st.x * 50;
+    return st;
+}
+
+struct State evaluateMotion(const struct Motion* m, Tick tick) {
+    return evaluate(m, &m->bank, tick);
+}
+
+struct State evaluateState(struct Engine* e, Tick tick) {
+    struct Motion m;
+    captureFields(e, &m);
+    return evaluate(&m, &e->bank, tick);
+}
+
+// The numerical state without evaluateState()'s blend, for output that must
+// be the integrated solution itself: fixed-step methods give their last step,
+// the others their state at tick.
+struct State integratedState(struct Engine* e, Tick tick) {
+    int method = activeMethod(e);
+    if (method == ANALYTIC || method == DORMAND_PRINCE) { return evaluateState(e, tick); }
+
+    struct State st;
+    struct Params* p = &e->params;
+    struct Model m = engineModel(e);
+    st.x = e->state.x;
+    st.v = e->state.v;
+    st.a = accel(&m, e->state.x, e->state.v, e->state.t);
+    st.screenPos = (p->Xmax > 4) ? st.x * 200 / p->Xmax : st.x * 50;
+    return st;
+}
+
+// Screen positions of the closed-form motion at start, start + step, ... for
+// n samples, from the parameters alone, in one batch. The undamped case runs
+// on the phasor generator, started from the same fixed-point phase the live
+// path reads, so the two agree however long the run; damped or driven motion
+// goes through sampleSolution()'s recurrence. The motion starts at t = 0, so
+// start must not be negative. Returns false if the parameters have no closed
+// form.
+bool sampleTrace(const struct Params* p, Tick start, Tick step, float* out, int n) {
+    float scale = (p->Xmax > 4) ? 200 / p->Xmax : 50;
+    double t0 = secondsFromTicks(start);
+    double dt = secondsFromTicks(step);
+
+    if (p->damping == 0 && p->driveForce == 0) {
+        struct PhaseAccumulator phase;
+        initPhase(&phase, p->omega, p->phi);
+        struct Phasor ph;
+        initPhasor(&ph, p->Xmax * scale, p->omega, phaseAt(&phase, start), dt);
+        phasorFill(&ph, out, n);
+        return true;
+    }
+
+    struct Model m;
+    m.mass = p->mass;
+    m.k = p->k;
+    m.c = p->damping;
+    m.F = p->driveForce;
+    m.wd = p->driveOmega;
+    if (!hasClosedForm(&m)) { return false; }
+
+    struct Solution s;
+    solveAnalytic(&s, &m, p->Xmax * cos(p->phi), - p->omega * p->Xmax * sin(p->phi), 0);
+    sampleSolution(&s, t0, dt, out, n);
+    for (int i = 0; i < n; i++) {
+        out[i] *= scale;
+    }
+    return true;
+}
+
+// Simulation time in integer nanosecond ticks, from the Chronometer's
+// microseconds, saturated at TICK_MAX.
+Tick engineTick(struct Engine* e) {
+    sf::Int64 us = e->clock.getElapsedTime().asMicroseconds();
+    if (us >= TICK_MAX / (TICKS_PER_SECOND / 1000000)) { return TICK_MAX; }
+    return us * (TICKS_PER_SECOND / 1000000);
+}
+
+struct Model engineModel(struct Engine* e) {
+    struct Model m;
+    m.mass = e->params.mass;
+    m.k = e->params.k;
+    m.c = e->params.damping;
+    m.F = e->params.driveForce;
+    m.wd = e->params.driveOmega;
+    return m;
+}
+
+// The analytic mode falls back to RK4 for parameters without a closed form.
+int activeMethod(struct Engine* e) {
+    if (e->params.method != ANALYTIC) { return e->params.method; }
+    struct Model m = engineModel(e);
+    return hasClosedForm(&m) ? ANALYTIC : RK4;
+}
+
+// Re-solves the closed form from the initial conditions x max and phi give at
+// t = 0, and restarts the numerical state from it at time t.
+void resetState(struct Engine* e, double t) {
+    struct Params* p = &e->params;
+    struct Model m = engineModel(e);
+    double x0 = p->Xmax * cos(p->phi);
+    double v0 = - p->omega * p->Xmax * sin(p->phi);
+    initPhase(&e->phase, p->omega, p->phi);
+    setOscillator(&e->bank, 0, p->mass, p->k, p->Xmax, p->phi);
+
+    if (hasClosedForm(&m)) {
+        solveAnalytic(&e->solution, &m, x0, v0, 0);
+        evaluateSolution(&e->solution, t, &e->state.x, &e->state.v);
+    } else {
+        e->state.x = x0;
+        e->state.v = v0;
+    }
+    e->state.t = t;
+    e->prevState = e->state;
+    e->energy0 = energy(&m, &e->state);
+    e->stale = false;
+
+    if (activeMethod(e) == DORMAND_PRINCE) {
+        initDormandPrince(&e->adaptive, &m, &e->state, 1e-9, 1e-12, 1e-3 * p->Xmax);
+        e->lastUpCrossing = -1;
+        e->measuredPeriod = 0;
+    }
+}
+
+static void advanceEngine(struct Engine* e, double t);
+
+// Advances the numerical state in fixed dt steps up to time t. Seeks backwards,
+// jumps of more than a second and parameter edits restart from the closed form.
+void stepEngine(struct Engine* e, double t) {
+    int method = activeMethod(e);
+
+    if (e->stale || (method != ANALYTIC && (t < e->state.t || t - e->state.t > 1))) {
+        resetState(e, t);
+        return;
+    }
+    if (method == ANALYTIC) { return; }
+    advanceEngine(e, t);
+}
+
+// stepEngine() for the clock's own advance. A numerical method more than
+// ENGINE_CATCH_UP steps behind tick is advanced by that many and the rest is
+// taken off the clock, rather than restarted from the closed form: above
+// the time scale the integrator can keep up with, simulated time falls
+// behind wall time and limited is set. Returns the tick reached.
+Tick catchUpEngine(struct Engine* e, Tick tick) {
+    int method = activeMethod(e);
+    double t = secondsFromTicks(tick);
+    e->limited = false;
+    if (e->stale || method == ANALYTIC || t < e->state.t) {
+        stepEngine(e, t);
+        return tick;
+    }
+
+    double most = ENGINE_CATCH_UP * e->dt;
+    if (t - e->state.t <= most) {
+        advanceEngine(e, t);
+        return tick;
+    }
+    Tick reached = ticksFromSeconds(e->state.t + most);
+    advanceEngine(e, secondsFromTicks(reached));
+    // Truncated to whole microseconds, so the clock never reads before reached.
+    e->clock.add(sf::microseconds(- (tick - reached) / (TICKS_PER_SECOND / 1000000)));
+    e->limited = true;
+    return reached;
+}
+
+static void advanceEngine(struct Engine* e, double t) {
+    int method = activeMethod(e);
+    struct Model m = engineModel(e);
+    if (method == DORMAND_PRINCE) {
+        advanceDormandPrince(&e->adaptive, &m, t, &e->state);
+        int lim = e->adaptive.events.size();
+        for (int i = 0; i < lim; i++) {
+            struct Event* ev = &e->adaptive.events[i];
+            if (ev->type != ZERO_CROSSING || ev->direction < 0) { continue; }
+            if (e->lastUpCrossing >= 0) { e->measuredPeriod = ev->t - e->lastUpCrossing; }
+            e->lastUpCrossing = ev->t;
+        }
+        e->adaptive.events.clear();
+        return;
+    }
+
+    Stepper f = stepper((enum Method) method);
+    int steps = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (e->state.t + e->dt <= t) {
+        e->prevState = e->state;
+        f(&m, &e->state, e->dt);
+        steps++;
+    }
+    if (steps) {
+        std::chrono::duration<double, std::nano> spent = std::chrono::steady_clock::now() - start;
+        e->stepCost = 0.9 * e->stepCost + 0.1 * spent.count() / steps;
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include "Chronometer.hpp"
+#include "VirtualClock.hpp"
+#include "Integrator.hpp"
+#include "DormandPrince.hpp"
+#include "Analytic.hpp"
+#include "Phase.hpp"
+#include "Oscillator.hpp"
+
+// The spring-mass simulation, independent of any window: the user-facing
+// parameters, the simulation clock and the numerical state behind them.
+
+#define PI 3.14159265
+#define ENGINE_CATCH_UP 20000   // most steps per catchUpEngine()
+
+// Everything the options panel edits. period, omega and k are kept
+// consistent with each other by setPeriod().
+struct Params {
+    float mass;
+    float k;
+    float omega;
+    float Xmax;
+    float period;
+    float phi;
+    float damping;
+    float driveForce;
+    float driveOmega;
+    int method;
+};
+
+struct Engine {
+    struct Params params;
+    sftools::BasicChronometer<VirtualClock> clock;
+    struct PhaseAccumulator phase;
+    struct OscillatorBank bank;     // slot 0: the undamped motion, at phase
+    double dt;
+    struct Oscillation state;
+    struct Oscillation prevState;
+    double energy0;
+    double stepCost;
+    struct Solution solution;
+    struct DormandPrince adaptive;
+    double lastUpCrossing;
+    double measuredPeriod;
+    bool stale;
+    bool limited;       // the last catchUpEngine() fell behind the clock
+};
+
+struct State {
+    float x;
+    float v;
+    float a;
+    float screenPos;
+};
+
+// What evaluateState() reads from an Engine, copied out so the mass can be
+// placed at any instant up to the next step without the Engine itself.
+struct Motion {
+    struct Params params;
+    struct Model model;
+    int method;                     // activeMethod()
+    struct PhaseAccumulator phase;
+    struct OscillatorBank bank;
+    struct Solution solution;
+    struct DormandPrince adaptive;  // its last step's dense output
+    double dt;
+    struct Oscillation state;
+    struct Oscillation prevState;
+};
+
+void initParams(struct Params* p);
+float calcOmega(const struct Params* p);
+float calcPeriod(const struct Params* p);
+void setPeriod(struct Params* p, float period);
+
+void initEngine(struct Engine* e);
+void setParams(struct Engine* e, const struct Params* p);
+Tick engineTick(struct Engine* e);
+void captureMotion(struct Engine* e, struct Motion* m);
+struct State evaluateMotion(const struct Motion* m, Tick tick);
+struct State evaluateState(struct Engine* e, Tick tick);
+struct State integratedState(struct Engine* e, Tick tick);
+struct Model engineModel(struct Engine* e);
+int activeMethod(struct Engine* e);
+void resetState(struct Engine* e, double t);
+void stepEngine(struct Engine* e, double t);
+Tick catchUpEngine(struct Engine* e, Tick tick);
+bool sampleTrace(const struct Params* p, Tick start, Tick step, float* out, int n);
+
+#endif // ENGINE_HPP
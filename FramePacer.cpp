@@ -0,0 +1,55 @@
+#include "FramePacer.hpp"
+#include <cmath>
+#include <thread>
+
+const char* pacingNames[PACING_MODE_COUNT] = {
+    "vsync",
+    "sleep",
+    "uncapped"
+};
+
+void initPacer(struct FramePacer* p, sf::RenderWindow* window, double interval, int mode) {
+    p->interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval));
+    p->last = std::chrono::steady_clock::now();
+    p->deadline = p->last + p->interval;
+    p->frameTime = interval * 1000;
+    p->jitter = 0;
+    setPacingMode(p, window, mode);
+}
+
+void setPacingMode(struct FramePacer* p, sf::RenderWindow* window, int mode) {
+    p->mode = mode;
+    window->setVerticalSyncEnabled(mode == VSYNC);
+    p->deadline = std::chrono::steady_clock::now() + p->interval;
+}
+
+// Call once per frame, after window.display().
+void waitFrame(struct FramePacer* p) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (p->mode == SLEEP) {
+        if (p->deadline - now > PACER_SPIN) {
+            std::this_thread::sleep_until(p->deadline - PACER_SPIN);
+        }
+        while (std::chrono::steady_clock::now() < p->deadline) {
+        }
+        now = std::chrono::steady_clock::now();
+
+        // Advance by whole intervals so a late frame doesn't shorten the next
+        // ones; resynchronize if we fell more than a frame behind.
+        p->deadline += p->interval;
+        if (now > p->deadline) { p->deadline = now + p->interval; }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(now - p->last).count();
+    p->last = now;
+    p->frameTime = 0.95 * p->frameTime + 0.05 * ms;
+    p->jitter = 0.95 * p->jitter + 0.05 * fabs(ms - p->frameTime);
+}
+
+// Call after the loop sat idle, so the gap neither counts as a frame nor
+// leaves a deadline far in the past.
+void resumePacer(struct FramePacer* p) {
+    p->last = std::chrono::steady_clock::now();
+    p->deadline = p->last + p->interval;
+}
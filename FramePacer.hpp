@@ -0,0 +1,40 @@
+#ifndef FRAMEPACER_HPP
+#define FRAMEPACER_HPP
+
+#include <chrono>
+#include <SFML/Graphics.hpp>
+
+// Paces the main loop without busy-waiting on the clock.
+//
+// VSYNC lets window.display() block on the display's refresh. SLEEP sleeps
+// until shortly before the next deadline and spins only for the last
+// PACER_SPIN, which absorbs the OS scheduler's wake-up latency. UNCAPPED
+// never waits. Achieved frame time and jitter (mean absolute deviation from
+// the average frame time) are tracked in every mode.
+
+#define PACER_SPIN std::chrono::microseconds(1000)
+
+enum PacingMode {
+    VSYNC,
+    SLEEP,
+    UNCAPPED,
+    PACING_MODE_COUNT
+};
+
+struct FramePacer {
+    int mode;
+    std::chrono::steady_clock::duration interval;
+    std::chrono::steady_clock::time_point deadline;
+    std::chrono::steady_clock::time_point last;
+    double frameTime;   // ms, smoothed
+    double jitter;      // ms, smoothed
+};
+
+extern const char* pacingNames[PACING_MODE_COUNT];
+
+void initPacer(struct FramePacer* p, sf::RenderWindow* window, double interval, int mode);
+void setPacingMode(struct FramePacer* p, sf::RenderWindow* window, int mode);
+void waitFrame(struct FramePacer* p);
+void resumePacer(struct FramePacer* p);
+
+#endif // FRAMEPACER_HPP
@@ -0,0 +1,108 @@
+#include "Integrator.hpp"
+#include <cmath>
+
+const char* methodNames[METHOD_COUNT] = {
+    "analytic",
+    "symplectic Euler",
+    "velocity Verlet",
+    "RK4",
+    "backward Euler",
+    "Newmark (trapezoidal)",
+    "Dormand-Prince (adaptive)"
+};
+
+double accel(const struct Model* m, double x, double v, double t) {
+    double f = - m->k * x - m->c * v;
+    if (m->F != 0) { f += m->F * cos(m->wd * t); }
+    return f / m->mass;
+}
+
+double energy(const struct Model* m, const struct Oscillation* s) {
+    return 0.5 * m->mass * s->v * s->v + 0.5 * m->k * s->x * s->x;
+}
+
+static void symplecticEuler(const struct Model* m, struct Oscillation* s, double dt) {
+    s->v += accel(m, s->x, s->v, s->t) * dt;
+    s->x += s->v * dt;
+    s->t += dt;
+}
+
+static void velocityVerlet(const struct Model* m, struct Oscillation* s, double dt) {
+    double a = accel(m, s->x, s->v, s->t);
+    double vh = s->v + 0.5 * a * dt;
+    s->x += vh * dt;
+    s->t += dt;
+    s->v = vh + 0.5 * accel(m, s->x, vh, s->t) * dt;
+}
+
+static void rk4(const struct Model* m, struct Oscillation* s, double dt) {
+    double x = s->x, v = s->v, t = s->t;
+
+    double k1x = v;
+    double k1v = accel(m, x, v, t);
+    double k2x = v + 0.5 * dt * k1v;
+    double k2v = accel(m, x + 0.5 * dt * k1x, k2x, t + 0.5 * dt);
+    double k3x = v + 0.5 * dt * k2v;
+    double k3v = accel(m, x + 0.5 * dt * k2x, k3x, t + 0.5 * dt);
+    double k4x = v + dt * k3v;
+    double k4v = accel(m, x + dt * k3x, k4x, t + dt);
+
+    s->x = x + dt / 6 * (k1x + 2 * k2x + 2 * k3x + k4x);
+    s->v = v + dt / 6 * (k1v + 2 * k2v + 2 * k3v + k4v);
+    s->t = t + dt;
+}
+
+// Both implicit schemes solve the linear spring equation for the end-of-step
+// state directly, so no Newton iteration is needed. With g = c / m and f the
+// drive per unit mass, a = f - w2 x - g v.
+static void backwardEuler(const struct Model* m, struct Oscillation* s, double dt) {
+    double w2 = m->k / m->mass;
+    double g = m->c / m->mass;
+    double f = m->F * cos(m->wd * (s->t + dt)) / m->mass;
+    double x = (s->x * (1 + dt * g) + dt * s->v + dt * dt * f) / (1 + dt * g + dt * dt * w2);
+    s->v = (x - s->x) / dt;
+    s->x = x;
+    s->t += dt;
+}
+
+// Newmark-beta with beta = 1/4, gamma = 1/2 (average acceleration), which is
+// the implicit trapezoidal rule: unconditionally stable and energy conserving.
+static void newmark(const struct Model* m, struct Oscillation* s, double dt) {
+    double w2 = m->k / m->mass;
+    double g = m->c / m->mass;
+    double f = m->F * cos(m->wd * (s->t + dt)) / m->mass;
+    double a0 = accel(m, s->x, s->v, s->t);
+    double X = s->x + dt * s->v;
+    // sum = a0 + a1, from a1 = f - w2 (X + dt^2/4 sum) - g (v0 + dt/2 sum)
+    double sum = (a0 - w2 * X - g * s->v + f) / (1 + 0.25 * dt * dt * w2 + 0.5 * dt * g);
+    s->x = X + 0.25 * dt * dt * sum;
+    s->v += 0.5 * dt * sum;
+    s->t += dt;
+}
+
+Stepper stepper(enum Method method) {
+    switch (method) {
+        case SYMPLECTIC_EULER: return symplecticEuler;
+        case VELOCITY_VERLET: return velocityVerlet;
+        case RK4: return rk4;
+        case BACKWARD_EULER: return backwardEuler;
+        case NEWMARK: return newmark;
+        default: return 0;
+    }
+}
+
+void integrate(enum Method method, const struct Model* m, struct Oscillation* s, double dt) {
+    Stepper f = stepper(method);
+    if (f) { f(m, s, dt); }
+}
+
+bool isImplicit(enum Method method) {
+    return method == BACKWARD_EULER || method == NEWMARK;
+}
+
+// Substeps per dt an explicit scheme needs to stay stable; velocity Verlet and
+// symplectic Euler require omega * h < 2.
+int explicitSubsteps(const struct Model* m, double dt) {
+    double omega = sqrt(m->k / m->mass);
+    return (int) ceil(omega * dt / 2);
+}
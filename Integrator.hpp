@@ -0,0 +1,47 @@
+#ifndef INTEGRATOR_HPP
+#define INTEGRATOR_HPP
+
+// Numerical time stepping for the spring-mass equations. ANALYTIC is the
+// closed-form reference and has no stepper; the other methods advance an
+// Oscillation by a fixed dt. BACKWARD_EULER and NEWMARK are implicit and
+// stay stable at any dt, which is what large k at the render step needs.
+// DORMAND_PRINCE chooses its own steps and has no fixed-dt stepper either; see
+// DormandPrince.hpp.
+enum Method {
+    ANALYTIC,
+    SYMPLECTIC_EULER,
+    VELOCITY_VERLET,
+    RK4,
+    BACKWARD_EULER,
+    NEWMARK,
+    DORMAND_PRINCE,
+    METHOD_COUNT
+};
+
+// m x'' + c x' + k x = F cos(wd t)
+struct Model {
+    double mass;
+    double k;
+    double c;
+    double F;
+    double wd;
+};
+
+struct Oscillation {
+    double x;
+    double v;
+    double t;
+};
+
+typedef void (*Stepper)(const struct Model* m, struct Oscillation* s, double dt);
+
+extern const char* methodNames[METHOD_COUNT];
+
+double accel(const struct Model* m, double x, double v, double t);
+double energy(const struct Model* m, const struct Oscillation* s);
+Stepper stepper(enum Method method);
+void integrate(enum Method method, const struct Model* m, struct Oscillation* s, double dt);
+bool isImplicit(enum Method method);
+int explicitSubsteps(const struct Model* m, double dt);
+
+#endif // INTEGRATOR_HPP
@@ -0,0 +1,331 @@
+#include "Journal.hpp"
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+// Every Params field is four bytes, so a field is just an offset.
+static const size_t paramOffsets[] = {
+    offsetof(struct Params, mass),
+    offsetof(struct Params, k),
+    offsetof(struct Params, omega),
+    offsetof(struct Params, Xmax),
+    offsetof(struct Params, period),
+    offsetof(struct Params, phi),
+    offsetof(struct Params, damping),
+    offsetof(struct Params, driveForce),
+    offsetof(struct Params, driveOmega),
+    offsetof(struct Params, method)
+};
+
+#define PARAM_FIELDS (int) (sizeof(paramOffsets) / sizeof(paramOffsets[0]))
+
+static void putBytes(std::vector<unsigned char>* out, const void* data, int n) {
+    const unsigned char* b = (const unsigned char*) data;
+    out->insert(out->end(), b, b + n);
+}
+
+static void putVarint(std::vector<unsigned char>* out, unsigned long long v) {
+    while (v >= 0x80) {
+        out->push_back((unsigned char) (v | 0x80));
+        v >>= 7;
+    }
+    out->push_back((unsigned char) v);
+}
+
+static void putTick(std::vector<unsigned char>* out, Tick t) {
+    putVarint(out, ((unsigned long long) t << 1) ^ (unsigned long long) (t >> 63));
+}
+
+static bool getBytes(const unsigned char** p, const unsigned char* end, void* data, int n) {
+    if (end - *p < n) { return false; }
+    memcpy(data, *p, n);
+    *p += n;
+    return true;
+}
+
+static bool getVarint(const unsigned char** p, const unsigned char* end, unsigned long long* v) {
+    *v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*p == end) { return false; }
+        unsigned char b = *(*p)++;
+        *v |= (unsigned long long) (b & 0x7f) << shift;
+        if (!(b & 0x80)) { return true; }
+    }
+    return false;
+}
+
+static bool getTick(const unsigned char** p, const unsigned char* end, Tick* t) {
+    unsigned long long v;
+    if (!getVarint(p, end, &v)) { return false; }
+    *t = (Tick) (v >> 1) ^ - (Tick) (v & 1);
+    return true;
+}
+
+void initJournal(struct Journal* j, struct Engine* e) {
+    j->initial = e->params;
+    j->dt = e->dt;
+    j->scale = e->clock.getClock().getScale();
+    j->end = 0;
+    j->entries.clear();
+}
+
+// Physics thread only.
+void recordCommand(struct Journal* j, Tick tick, const struct Command* c) {
+    struct JournalEntry entry;
+    entry.tick = tick;
+    entry.command = *c;
+    j->entries.push_back(entry);
+}
+
+bool saveJournal(const struct Journal* j, const char* path) {
+    std::vector<unsigned char> out;
+    putBytes(&out, JOURNAL_MAGIC, 4);
+    out.push_back(JOURNAL_VERSION);
+    putBytes(&out, &j->initial, sizeof(j->initial));
+    putBytes(&out, &j->dt, sizeof(j->dt));
+    putBytes(&out, &j->scale, sizeof(j->scale));
+    putTick(&out, j->end);
+    putVarint(&out, j->entries.size());
+
+    struct Params prev = j->initial;
+    Tick last = 0;
+    int lim = j->entries.size();
+    for (int i = 0; i < lim; i++) {
+        const struct JournalEntry* e = &j->entries[i];
+        const struct Command* c = &e->command;
+        putTick(&out, e->tick - last);
+        last = e->tick;
+        out.push_back((unsigned char) c->type);
+
+        if (c->type == SET_PARAMS) {
+            unsigned int mask = 0;
+            for (int f = 0; f < PARAM_FIELDS; f++) {
+                if (memcmp((const char*) &c->params + paramOffsets[f], (const char*) &prev + paramOffsets[f], 4)) {
+                    mask |= 1 << f;
+                }
+            }
+            putVarint(&out, mask);
+            for (int f = 0; f < PARAM_FIELDS; f++) {
+                if (mask & (1 << f)) { putBytes(&out, (const char*) &c->params + paramOffsets[f], 4); }
+            }
+            prev = c->params;
+        } else if (c->type == SET_PAUSED) {
+            out.push_back(c->value != 0);
+        } else {
+            putBytes(&out, &c->value, sizeof(c->value));
+        }
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) { return false; }
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool loadJournal(struct Journal* j, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) { return false; }
+    std::vector<unsigned char> in;
+    unsigned char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        in.insert(in.end(), buffer, buffer + n);
+    }
+    fclose(file);
+
+    const unsigned char* p = in.data();
+    const unsigned char* end = p + in.size();
+    char magic[4];
+    unsigned char version;
+    unsigned long long count;
+    if (!getBytes(&p, end, magic, 4) || memcmp(magic, JOURNAL_MAGIC, 4)) { return false; }
+    if (!getBytes(&p, end, &version, 1) || version != JOURNAL_VERSION) { return false; }
+    if (!getBytes(&p, end, &j->initial, sizeof(j->initial))) { return false; }
+    if (!getBytes(&p, end, &j->dt, sizeof(j->dt))) { return false; }
+    if (!getBytes(&p, end, &j->scale, sizeof(j->scale))) { return false; }
+    if (!getTick(&p, end, &j->end)) { return false; }
+    if (!getVarint(&p, end, &count)) { return false; }
+
+    j->entries.clear();
+    struct Params prev = j->initial;
+    Tick last = 0;
+    for (unsigned long long i = 0; i < count; i++) {
+        struct JournalEntry e;
+        struct Command* c = &e.command;
+        unsigned char type;
+        Tick delta;
+        if (!getTick(&p, end, &delta) || !getBytes(&p, end, &type, 1)) { return false; }
+        e.tick = last + delta;
+        last = e.tick;
+        c->type = type;
+        c->params = prev;
+        c->value = 0;
+
+        if (type == SET_PARAMS) {
+            unsigned long long mask;
+            if (!getVarint(&p, end, &mask)) { return false; }
+            for (int f = 0; f < PARAM_FIELDS; f++) {
+                if (!(mask & (1 << f))) { continue; }
+                if (!getBytes(&p, end, (char*) &c->params + paramOffsets[f], 4)) { return false; }
+            }
+            prev = c->params;
+        } else if (type == SET_PAUSED) {
+            unsigned char paused;
+            if (!getBytes(&p, end, &paused, 1)) { return false; }
+            c->value = paused;
+        } else if (type <= SET_TIME_SCALE) {
+            if (!getBytes(&p, end, &c->value, sizeof(c->value))) { return false; }
+        } else {
+            return false;
+        }
+        j->entries.push_back(e);
+    }
+    return true;
+}
+
+static void addKeyframe(struct Replay* r) {
+    struct Keyframe k;
+    k.next = r->next;
+    k.tick = r->tick;
+    k.scale = r->scale;
+    k.chunks = r->chunks;
+    k.engine = r->engine;
+    r->keyframes.push_back(k);
+}
+
+static void restoreKeyframe(struct Replay* r, const struct Keyframe* k) {
+    r->next = k->next;
+    r->tick = k->tick;
+    r->scale = k->scale;
+    r->chunks = k->chunks;
+    r->engine = k->engine;
+}
+
+// How far the live physics thread moved per iteration, but at least
+// REPLAY_CHUNK, below which stepEngine() never restarts.
+static Tick chunkTicks(const struct Replay* r) {
+    Tick live = ticksFromSeconds(r->scale * r->engine.dt);
+    return live > REPLAY_CHUNK ? live : REPLAY_CHUNK;
+}
+
+// Steps through absolute multiples of the chunk length, so every pass over
+// the same stretch of session calls stepEngine() at the same ticks.
+static void advanceTo(struct Replay* r, Tick tick) {
+    while (r->tick < tick) {
+        Tick chunk = chunkTicks(r);
+        Tick boundary = (r->tick / chunk + 1) * chunk;
+        if (boundary > tick) {
+            stepEngine(&r->engine, secondsFromTicks(tick));
+            r->tick = tick;
+            break;
+        }
+        stepEngine(&r->engine, secondsFromTicks(boundary));
+        r->tick = boundary;
+        r->chunks++;
+        if (r->indexing && r->chunks % KEYFRAME_CHUNKS == 0) { addKeyframe(r); }
+    }
+    if (r->tick > r->horizon) { r->horizon = r->tick; }
+}
+
+static Tick entryEnd(const struct JournalEntry* e) {
+    return e->command.type == SEEK ? ticksFromSeconds(e->command.value) : e->tick;
+}
+
+static void applyEntry(struct Replay* r) {
+    const struct JournalEntry* e = &r->journal->entries[r->next];
+    advanceTo(r, e->tick);
+    simulateCommand(&r->engine, &e->command, e->tick);
+    if (e->command.type == SET_TIME_SCALE) { r->scale = e->command.value; }
+    r->tick = entryEnd(e);
+    r->next++;
+    if (r->tick > r->horizon) { r->horizon = r->tick; }
+}
+
+// Re-simulates the whole session once, leaving keyframes along the way, and
+// rewinds to its start.
+void initReplay(struct Replay* r, const struct Journal* j) {
+    r->journal = j;
+    initEngine(&r->engine);
+    setParams(&r->engine, &j->initial);
+    r->engine.dt = j->dt;
+    stepEngine(&r->engine, 0);
+    r->next = 0;
+    r->tick = 0;
+    r->scale = j->scale;
+    r->chunks = 0;
+    r->horizon = 0;
+    r->keyframes.clear();
+
+    r->indexing = true;
+    addKeyframe(r);
+    int count = j->entries.size();
+    while (r->next < count) { applyEntry(r); }
+    advanceTo(r, j->end);
+    r->indexing = false;
+
+    restoreKeyframe(r, &r->keyframes[0]);
+}
+
+// Moves the replay forward by ticks of simulation time, applying the input
+// met on the way. Returns false once the end of the session is reached.
+bool playReplay(struct Replay* r, Tick ticks) {
+    const struct Journal* j = r->journal;
+    int count = j->entries.size();
+    while (true) {
+        Tick end = r->next < count ? j->entries[r->next].tick : j->end;
+        if (end < r->tick) { end = r->tick; }
+        if (r->tick + ticks < end) {
+            advanceTo(r, r->tick + ticks);
+            return true;
+        }
+        ticks -= end - r->tick;
+        if (r->next == count) {
+            advanceTo(r, end);
+            return false;
+        }
+        applyEntry(r);
+    }
+}
+
+// Jumps to the first moment of the session at which the simulation reached
+// tick, re-simulating from the nearest earlier keyframe.
+void seekReplay(struct Replay* r, Tick tick) {
+    const struct Journal* j = r->journal;
+    int count = j->entries.size();
+
+    // A tick the session never simulated, skipped by a seek, snaps to the
+    // next segment that starts after it, or to the end.
+    int segment = -1;
+    int later = -1;
+    Tick laterStart = 0;
+    Tick start = 0;
+    for (int i = 0; i <= count && segment < 0; i++) {
+        Tick end = i < count ? j->entries[i].tick : j->end;
+        if (start <= tick && tick <= end) { segment = i; }
+        if (later < 0 && start > tick) {
+            later = i;
+            laterStart = start;
+        }
+        if (i < count) { start = entryEnd(&j->entries[i]); }
+    }
+    if (segment < 0 && later >= 0) {
+        segment = later;
+        tick = laterStart;
+    } else if (segment < 0) {
+        segment = count;
+        tick = j->end;
+    }
+
+    int lo = 0;
+    int hi = r->keyframes.size();
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        const struct Keyframe* k = &r->keyframes[mid];
+        if (k->next < segment || (k->next == segment && k->tick <= tick)) { lo = mid; }
+        else { hi = mid; }
+    }
+
+    restoreKeyframe(r, &r->keyframes[lo]);
+    while (r->next < segment) { applyEntry(r); }
+    advanceTo(r, tick);
+}
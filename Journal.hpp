@@ -0,0 +1,75 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <vector>
+#include "Physics.hpp"
+
+// Deterministic record of a session's input, and its replay.
+//
+// The physics thread records every Command it applies with the simulation
+// tick it applied it at. Commands change the simulation only through
+// simulateCommand(), and fixed-step methods step on a grid anchored at their
+// last reset, so re-applying the journal at the same ticks reproduces the
+// run exactly, however differently the replay slices time in between.
+// Live runs at time scales beyond 1 / Engine::dt seconds per second restart
+// from the closed form on every physics iteration; the replay emulates that
+// in steps of the same length, but not at the same instants.
+//
+// On disk a journal is a small header followed by one record per command:
+// the tick delta as a zigzag varint, the command type, and for SET_PARAMS
+// only the fields that differ from the previous parameters. Values are in
+// the host's byte order.
+
+#define JOURNAL_MAGIC "MHSJ"
+#define JOURNAL_VERSION 1
+#define REPLAY_CHUNK (TICKS_PER_SECOND / 2)
+#define KEYFRAME_CHUNKS 64
+
+struct JournalEntry {
+    Tick tick;
+    struct Command command;
+};
+
+struct Journal {
+    struct Params initial;
+    double dt;
+    double scale;
+    Tick end;       // last simulated tick, set by stopPhysics()
+    std::vector<struct JournalEntry> entries;
+};
+
+// The replay state at some position of the session, taken every
+// KEYFRAME_CHUNKS steps while indexing so a seek only re-simulates from the
+// nearest one.
+struct Keyframe {
+    int next;
+    Tick tick;
+    double scale;
+    long long chunks;
+    struct Engine engine;
+};
+
+// A position in the session is the number of entries applied so far plus
+// the simulation tick reached since.
+struct Replay {
+    const struct Journal* journal;
+    struct Engine engine;
+    int next;
+    Tick tick;
+    double scale;
+    long long chunks;
+    Tick horizon;   // latest tick the session reached
+    bool indexing;
+    std::vector<struct Keyframe> keyframes;
+};
+
+void initJournal(struct Journal* j, struct Engine* e);
+void recordCommand(struct Journal* j, Tick tick, const struct Command* c);
+bool saveJournal(const struct Journal* j, const char* path);
+bool loadJournal(struct Journal* j, const char* path);
+
+void initReplay(struct Replay* r, const struct Journal* j);
+bool playReplay(struct Replay* r, Tick ticks);
+void seekReplay(struct Replay* r, Tick tick);
+
+#endif // JOURNAL_HPP
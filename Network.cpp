@@ -0,0 +1,256 @@
+#include "Network.hpp"
+#include <cmath>
+#include <chrono>
+
+static void stopPool(struct Network* net);
+
+void initNetwork(struct Network* net, int threads) {
+    stopPool(net);
+    net->nodes = 0;
+    net->pos.clear();
+    net->vel.clear();
+    net->force.clear();
+    net->invMass.clear();
+    net->springA.clear();
+    net->springB.clear();
+    net->rest.clear();
+    net->k.clear();
+    net->rowStart.clear();
+    net->adjNode.clear();
+    net->adjSpring.clear();
+    net->damping = 0;
+    net->gravity[0] = net->gravity[1] = net->gravity[2] = 0;
+    net->threads = (threads > 0) ? threads : 1;
+}
+
+int addNode(struct Network* net, float x, float y, float z, float mass) {
+    net->pos.push_back(x);
+    net->pos.push_back(y);
+    net->pos.push_back(z);
+    for (int c = 0; c < 3; c++) {
+        net->vel.push_back(0);
+        net->force.push_back(0);
+    }
+    net->invMass.push_back((mass > 0) ? 1 / mass : 0);
+    return net->nodes++;
+}
+
+int addSpring(struct Network* net, int a, int b, float k) {
+    float dx = net->pos[3 * b] - net->pos[3 * a];
+    float dy = net->pos[3 * b + 1] - net->pos[3 * a + 1];
+    float dz = net->pos[3 * b + 2] - net->pos[3 * a + 2];
+    net->springA.push_back(a);
+    net->springB.push_back(b);
+    net->rest.push_back(sqrtf(dx * dx + dy * dy + dz * dz));
+    net->k.push_back(k);
+    return net->springA.size() - 1;
+}
+
+static void startPool(struct Network* net);
+
+// Builds the CSR adjacency from the edge list and starts the worker threads;
+// call after the last addSpring.
+void finalizeNetwork(struct Network* net) {
+    int springs = net->springA.size();
+    net->rowStart.assign(net->nodes + 1, 0);
+    for (int s = 0; s < springs; s++) {
+        net->rowStart[net->springA[s] + 1]++;
+        net->rowStart[net->springB[s] + 1]++;
+    }
+    for (int i = 0; i < net->nodes; i++) {
+        net->rowStart[i + 1] += net->rowStart[i];
+    }
+
+    std::vector<int> fill(net->rowStart.begin(), net->rowStart.end() - 1);
+    net->adjNode.resize(2 * springs);
+    net->adjSpring.resize(2 * springs);
+    for (int s = 0; s < springs; s++) {
+        int a = net->springA[s];
+        int b = net->springB[s];
+        net->adjNode[fill[a]] = b;
+        net->adjSpring[fill[a]++] = s;
+        net->adjNode[fill[b]] = a;
+        net->adjSpring[fill[b]++] = s;
+    }
+    startPool(net);
+}
+
+// w x h lattice in the xy plane with structural and shear springs; the top
+// row is pinned.
+void initCloth(struct Network* net, int w, int h, float spacing, float k, float mass, int threads) {
+    initNetwork(net, threads);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            addNode(net, x * spacing, y * spacing, 0, (y == 0) ? 0 : mass);
+        }
+    }
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int i = y * w + x;
+            if (x + 1 < w) { addSpring(net, i, i + 1, k); }
+            if (y + 1 < h) { addSpring(net, i, i + w, k); }
+            if (x + 1 < w && y + 1 < h) {
+                addSpring(net, i, i + w + 1, k);
+                addSpring(net, i + 1, i + w, k);
+            }
+        }
+    }
+    finalizeNetwork(net);
+    net->gravity[1] = 9.8f;
+    net->damping = 0.5f;
+}
+
+static void assembleForces(struct Network* net, int begin, int end) {
+    const float* pos = net->pos.data();
+    for (int i = begin; i < end; i++) {
+        float fx = 0, fy = 0, fz = 0;
+        for (int e = net->rowStart[i]; e < net->rowStart[i + 1]; e++) {
+            int j = net->adjNode[e];
+            int s = net->adjSpring[e];
+            float dx = pos[3 * j] - pos[3 * i];
+            float dy = pos[3 * j + 1] - pos[3 * i + 1];
+            float dz = pos[3 * j + 2] - pos[3 * i + 2];
+            float len = sqrtf(dx * dx + dy * dy + dz * dz);
+            if (len == 0) { continue; }
+            float f = net->k[s] * (len - net->rest[s]) / len;
+            fx += f * dx;
+            fy += f * dy;
+            fz += f * dz;
+        }
+        net->force[3 * i] = fx;
+        net->force[3 * i + 1] = fy;
+        net->force[3 * i + 2] = fz;
+    }
+}
+
+// Symplectic Euler: velocities from the current forces, then positions from
+// the new velocities.
+static void integrateNodes(struct Network* net, float dt, int begin, int end) {
+    float keep = 1 - net->damping * dt;
+    if (keep < 0) { keep = 0; }
+    for (int i = begin; i < end; i++) {
+        float w = net->invMass[i];
+        if (w == 0) { continue; }
+        for (int c = 0; c < 3; c++) {
+            float v = (net->vel[3 * i + c] + dt * (net->force[3 * i + c] * w + net->gravity[c])) * keep;
+            net->vel[3 * i + c] = v;
+            net->pos[3 * i + c] += dt * v;
+        }
+    }
+}
+
+// Thread t of the step's active ones takes the t-th contiguous block of nodes.
+static void stepBlock(struct Network* net, int t) {
+    struct NetworkPool* pool = &net->pool;
+    int chunk = (net->nodes + pool->active - 1) / pool->active;
+    int begin = (t * chunk < net->nodes) ? t * chunk : net->nodes;
+    int end = (begin + chunk < net->nodes) ? begin + chunk : net->nodes;
+
+    assembleForces(net, begin, end);
+
+    // Every force must be in before any position moves.
+    unsigned phase = pool->phase.load(std::memory_order_acquire);
+    if (pool->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == pool->active) {
+        pool->arrived.store(0, std::memory_order_relaxed);
+        pool->phase.fetch_add(1, std::memory_order_release);
+    } else {
+        while (pool->phase.load(std::memory_order_acquire) == phase) {
+            std::this_thread::yield();
+        }
+    }
+
+    integrateNodes(net, pool->dt, begin, end);
+}
+
+static void networkWorker(struct Network* net, int t) {
+    struct NetworkPool* pool = &net->pool;
+    unsigned seen = 0;
+    for (;;) {
+        unsigned generation = pool->generation.load(std::memory_order_acquire);
+        std::chrono::steady_clock::time_point until =
+            std::chrono::steady_clock::now() + std::chrono::microseconds(NETWORK_SPIN_US);
+        while (generation == seen && !pool->park.load(std::memory_order_relaxed)
+                && std::chrono::steady_clock::now() < until) {
+            std::this_thread::yield();
+            generation = pool->generation.load(std::memory_order_acquire);
+        }
+        if (generation == seen) {
+            std::unique_lock<std::mutex> hold(pool->lock);
+            pool->wake.wait(hold, [pool, seen]() { return pool->generation.load() != seen; });
+            generation = pool->generation.load();
+        }
+        seen = generation;
+        if (pool->quit) { return; }
+
+        stepBlock(net, t);
+        pool->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+static void startPool(struct Network* net) {
+    struct NetworkPool* pool = &net->pool;
+    stopPool(net);
+    int active = net->nodes / NETWORK_GRAIN;
+    if (active > net->threads) { active = net->threads; }
+    if (active < 1) { active = 1; }
+
+    pool->generation.store(0);
+    pool->pending.store(0);
+    pool->arrived.store(0);
+    pool->phase.store(0);
+    pool->park.store(false);
+    pool->active = active;
+    pool->dt = 0;
+    pool->quit = false;
+    for (int t = 1; t < active; t++) {
+        pool->workers.push_back(std::thread(networkWorker, net, t));
+    }
+}
+
+static void stopPool(struct Network* net) {
+    struct NetworkPool* pool = &net->pool;
+    if (pool->workers.empty()) { return; }
+    {
+        std::lock_guard<std::mutex> hold(pool->lock);
+        pool->quit = true;
+        pool->generation.fetch_add(1);
+    }
+    pool->wake.notify_all();
+    for (size_t t = 0; t < pool->workers.size(); t++) {
+        pool->workers[t].join();
+    }
+    pool->workers.clear();
+}
+
+void stepNetwork(struct Network* net, float dt) {
+    struct NetworkPool* pool = &net->pool;
+    if (pool->workers.empty()) {
+        assembleForces(net, 0, net->nodes);
+        integrateNodes(net, dt, 0, net->nodes);
+        return;
+    }
+
+    pool->dt = dt;
+    pool->park.store(false, std::memory_order_relaxed);
+    pool->pending.store(pool->workers.size(), std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> hold(pool->lock);
+        pool->generation.fetch_add(1);
+    }
+    pool->wake.notify_all();
+
+    stepBlock(net, 0);
+    while (pool->pending.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+// Blocks the workers now instead of after NETWORK_SPIN_US; the next
+// stepNetwork() wakes them as usual.
+void parkNetwork(struct Network* net) {
+    net->pool.park.store(true, std::memory_order_relaxed);
+}
+
+void freeNetwork(struct Network* net) {
+    stopPool(net);
+}
@@ -0,0 +1,76 @@
+#ifndef NETWORK_HPP
+#define NETWORK_HPP
+
+#include <vector>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Sparse mass-spring network (cloth-like lattices and the like).
+//
+// Positions, velocities and forces are xyz triples per node; 2D meshes keep
+// z at 0. Springs are stored as an edge list and, once finalized, as a CSR
+// adjacency (node -> incident springs). Force assembly walks the CSR rows in
+// parallel: each thread owns a contiguous block of nodes and only writes the
+// forces of its own nodes, so no atomics or per-thread buffers are needed, at
+// the price of evaluating every spring once from each end.
+//
+// The threads are started once, by finalizeNetwork(), and parked between
+// steps: a step wakes them, each assembles and then integrates its block with
+// a barrier in between, and the caller works the first block itself. After a
+// step they poll for NETWORK_SPIN_US for the next one before blocking, so
+// back-to-back steps skip the wakeup; parkNetwork() blocks them at once, for
+// callers that know no step follows soon, like a frame after its last
+// substep. A network gets one thread per NETWORK_GRAIN nodes at most, so
+// small ones stay serial. freeNetwork() stops them.
+
+#define NETWORK_GRAIN 256       // fewest nodes worth a thread
+#define NETWORK_SPIN_US 5       // polling after a step before a worker blocks
+
+struct NetworkPool {
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::atomic<unsigned> generation;   // bumped to start a step or to quit
+    std::atomic<int> pending;           // workers still in the step
+    std::atomic<int> arrived;           // at the barrier
+    std::atomic<unsigned> phase;        // bumped as the barrier opens
+    std::atomic<bool> park;             // block without polling until the next step
+    int active;                         // threads sharing a step, caller included
+    float dt;
+    bool quit;
+};
+
+struct Network {
+    int nodes;
+    std::vector<float> pos;
+    std::vector<float> vel;
+    std::vector<float> force;
+    std::vector<float> invMass; // 0 pins the node
+
+    std::vector<int> springA;
+    std::vector<int> springB;
+    std::vector<float> rest;
+    std::vector<float> k;
+
+    std::vector<int> rowStart;
+    std::vector<int> adjNode;
+    std::vector<int> adjSpring;
+
+    float damping;
+    float gravity[3];
+    int threads;
+    struct NetworkPool pool;
+};
+
+void initNetwork(struct Network* net, int threads);
+int addNode(struct Network* net, float x, float y, float z, float mass);
+int addSpring(struct Network* net, int a, int b, float k);
+void finalizeNetwork(struct Network* net);
+void initCloth(struct Network* net, int w, int h, float spacing, float k, float mass, int threads);
+void stepNetwork(struct Network* net, float dt);
+void parkNetwork(struct Network* net);
+void freeNetwork(struct Network* net);
+
+#endif // NETWORK_HPP
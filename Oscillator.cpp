@@ -0,0 +1,95 @@
+#include "Oscillator.hpp"
+#include "SinCos.hpp"
+#include <cmath>
+
+#define PI 3.14159265
+
+void initBank(struct OscillatorBank* b, int count) {
+    b->mass.assign(count, 1);
+    b->k.assign(count, 4 * PI * PI);
+    b->omega.assign(count, 2 * PI);
+    b->Xmax.assign(count, 1);
+    b->phi.assign(count, 0);
+    b->period.assign(count, 1);
+
+    b->x.assign(count, 0);
+    b->v.assign(count, 0);
+    b->a.assign(count, 0);
+}
+
+int addOscillator(struct OscillatorBank* b, float mass, float k, float Xmax, float phi) {
+    int i = bankSize(b);
+    b->mass.push_back(0);
+    b->k.push_back(0);
+    b->omega.push_back(0);
+    b->Xmax.push_back(0);
+    b->phi.push_back(0);
+    b->period.push_back(0);
+
+    b->x.push_back(0);
+    b->v.push_back(0);
+    b->a.push_back(0);
+
+    setOscillator(b, i, mass, k, Xmax, phi);
+    return i;
+}
+
+void setOscillator(struct OscillatorBank* b, int i, float mass, float k, float Xmax, float phi) {
+    b->mass[i] = mass;
+    b->k[i] = k;
+    b->Xmax[i] = Xmax;
+    b->phi[i] = phi;
+    b->omega[i] = sqrtf(k / mass);
+    b->period[i] = 2 * PI / b->omega[i];
+}
+
+// Same derivation as setPeriod() in main.cpp: mass is kept, k follows omega.
+void setOscillatorPeriod(struct OscillatorBank* b, int i, float period) {
+    b->period[i] = period;
+    b->omega[i] = 2 * PI / period;
+    b->k[i] = b->omega[i] * b->omega[i] * b->mass[i];
+}
+
+int bankSize(const struct OscillatorBank* b) {
+    return b->mass.size();
+}
+
+void evaluateOscillator(const struct OscillatorBank* b, int i, float t, float* x, float* v, float* a) {
+    evaluateOscillatorPhase(b, i, b->omega[i] * t + b->phi[i], x, v, a);
+}
+
+// For callers that keep the phase themselves, like the Engine's exact
+// accumulator; phi is then already part of it.
+void evaluateOscillatorPhase(const struct OscillatorBank* b, int i, float phase, float* x, float* v, float* a) {
+    float w = b->omega[i];
+    float A = b->Xmax[i];
+    float s, c;
+    sinCos(phase, &s, &c);
+
+    *x = A * c;
+    *v = - w * A * s;
+    *a = - w * w * A * c;
+}
+
+void evaluateBank(struct OscillatorBank* b, float t) {
+    int n = bankSize(b);
+    const float* omega = b->omega.data();
+    const float* Xmax = b->Xmax.data();
+    const float* phi = b->phi.data();
+    float* x = b->x.data();
+    float* v = b->v.data();
+    float* a = b->a.data();
+
+    // Phases go through x, sines through v, then both are scaled in place.
+    for (int i = 0; i < n; i++) {
+        x[i] = omega[i] * t + phi[i];
+    }
+    sinCosArray(x, v, x, n);
+
+    for (int i = 0; i < n; i++) {
+        float w = omega[i];
+        x[i] = Xmax[i] * x[i];
+        v[i] = - w * Xmax[i] * v[i];
+        a[i] = - w * w * x[i];
+    }
+}
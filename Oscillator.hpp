@@ -0,0 +1,42 @@
+#ifndef OSCILLATOR_HPP
+#define OSCILLATOR_HPP
+
+#include <vector>
+#include <cmath>
+
+// Sine and cosine of the same angle in one call.
+inline void sinCos(float phase, float* s, float* c) {
+#if defined(__GNUC__)
+    __builtin_sincosf(phase, s, c);
+#else
+    *s = sinf(phase);
+    *c = cosf(phase);
+#endif
+}
+
+// Structure-of-arrays storage for many independent spring-mass systems.
+// Parameters and evaluated state live in contiguous arrays so a whole bank
+// can be evaluated in a single pass.
+struct OscillatorBank {
+    std::vector<float> mass;
+    std::vector<float> k;
+    std::vector<float> omega;
+    std::vector<float> Xmax;
+    std::vector<float> phi;
+    std::vector<float> period;
+
+    std::vector<float> x;
+    std::vector<float> v;
+    std::vector<float> a;
+};
+
+void initBank(struct OscillatorBank* b, int count);
+int addOscillator(struct OscillatorBank* b, float mass, float k, float Xmax, float phi);
+void setOscillator(struct OscillatorBank* b, int i, float mass, float k, float Xmax, float phi);
+void setOscillatorPeriod(struct OscillatorBank* b, int i, float period);
+int bankSize(const struct OscillatorBank* b);
+void evaluateOscillator(const struct OscillatorBank* b, int i, float t, float* x, float* v, float* a);
+void evaluateOscillatorPhase(const struct OscillatorBank* b, int i, float phase, float* x, float* v, float* a);
+void evaluateBank(struct OscillatorBank* b, float t);
+
+#endif // OSCILLATOR_HPP
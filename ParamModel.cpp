@@ -0,0 +1,72 @@
+#include "ParamModel.hpp"
+#include <cmath>
+
+struct Rule {
+    int trigger;
+    int target;
+    int inputs[2];      // -1 if unused
+    float (*eval)(const float* v);
+};
+
+static float omegaFromStiffness(const float* v) { return sqrtf(v[STIFFNESS] / v[MASS]); }
+static float omegaFromFrequency(const float* v) { return 2 * PI * v[FREQUENCY]; }
+static float omegaFromPeriod(const float* v) { return 2 * PI / v[PERIOD]; }
+static float frequencyFromOmega(const float* v) { return v[OMEGA] / (2 * PI); }
+static float periodFromOmega(const float* v) { return 2 * PI / v[OMEGA]; }
+static float stiffnessFromOmega(const float* v) { return v[OMEGA] * v[OMEGA] * v[MASS]; }
+
+static const struct Rule rules[] = {
+    { MASS,      OMEGA,     { STIFFNESS, MASS }, omegaFromStiffness },
+    { STIFFNESS, OMEGA,     { STIFFNESS, MASS }, omegaFromStiffness },
+    { FREQUENCY, OMEGA,     { FREQUENCY, -1 },   omegaFromFrequency },
+    { PERIOD,    OMEGA,     { PERIOD, -1 },      omegaFromPeriod },
+    { OMEGA,     FREQUENCY, { OMEGA, -1 },       frequencyFromOmega },
+    { OMEGA,     PERIOD,    { OMEGA, -1 },       periodFromOmega },
+    { OMEGA,     STIFFNESS, { OMEGA, MASS },     stiffnessFromOmega }
+};
+
+#define RULE_COUNT (int) (sizeof(rules) / sizeof(rules[0]))
+
+void initParamModel(struct ParamModel* m, const struct Params* p) {
+    m->value[MASS] = p->mass;
+    m->value[STIFFNESS] = p->k;
+    m->value[OMEGA] = p->omega;
+    m->value[FREQUENCY] = p->omega / (2 * PI);
+    m->value[PERIOD] = p->period;
+}
+
+// Returns false, leaving the model unchanged, for a mass that is not positive.
+bool setQuantity(struct ParamModel* m, int q, float value) {
+    if (q == MASS && !(value > 0)) { return false; }
+
+    bool held[QUANTITY_COUNT] = { false };
+    int queue[QUANTITY_COUNT];
+    int head = 0;
+    int tail = 0;
+
+    m->value[q] = value;
+    held[q] = true;
+    queue[tail++] = q;
+
+    while (head < tail) {
+        int from = queue[head++];
+        for (int r = 0; r < RULE_COUNT; r++) {
+            const struct Rule* rule = &rules[r];
+            if (rule->trigger != from || held[rule->target]) { continue; }
+            m->value[rule->target] = rule->eval(m->value);
+            for (int i = 0; i < 2; i++) {
+                if (rule->inputs[i] >= 0) { held[rule->inputs[i]] = true; }
+            }
+            held[rule->target] = true;
+            queue[tail++] = rule->target;
+        }
+    }
+    return true;
+}
+
+void modelParams(const struct ParamModel* m, struct Params* p) {
+    p->mass = m->value[MASS];
+    p->k = m->value[STIFFNESS];
+    p->omega = m->value[OMEGA];
+    p->period = m->value[PERIOD];
+}
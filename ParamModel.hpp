@@ -0,0 +1,33 @@
+#ifndef PARAMMODEL_HPP
+#define PARAMMODEL_HPP
+
+#include "Engine.hpp"
+
+// The oscillator's frequency parameters as a small reactive model.
+//
+// omega is the hub: f = omega / 2 pi, T = 2 pi / omega and k = omega^2 m.
+// Each rule is declared once with its trigger and inputs. setQuantity()
+// stores one edited value and walks the rules breadth-first from it, so every
+// dependent is recomputed exactly once and nothing else is touched. The
+// inputs of a rule that fired are held, which is what keeps k fixed when mass
+// is edited and mass fixed when k is edited. Values stay cached in the model
+// between edits; reading them never recomputes anything.
+
+enum Quantity {
+    MASS,
+    STIFFNESS,
+    OMEGA,
+    FREQUENCY,
+    PERIOD,
+    QUANTITY_COUNT
+};
+
+struct ParamModel {
+    float value[QUANTITY_COUNT];
+};
+
+void initParamModel(struct ParamModel* m, const struct Params* p);
+bool setQuantity(struct ParamModel* m, int q, float value);
+void modelParams(const struct ParamModel* m, struct Params* p);
+
+#endif // PARAMMODEL_HPP
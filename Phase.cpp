@@ -0,0 +1,82 @@
+#include "Phase.hpp"
+#include <cmath>
+
+// 2^64 / (2 pi 10^9) as an unevaluated double-double sum.
+#define TURN_SCALE_HI 2935890503.282001
+#define TURN_SCALE_LO 2.0797207390994053e-07
+#define TWO_PI_OVER_2_64 3.4061215800865545e-19
+
+Tick ticksFromSeconds(double seconds) {
+    double ticks = seconds * TICKS_PER_SECOND;
+    if (ticks >= TICK_MAX) { return TICK_MAX; }
+    if (ticks <= - TICK_MAX) { return - TICK_MAX; }
+    return llround(ticks);
+}
+
+double secondsFromTicks(Tick tick) {
+    return tick / (double) TICKS_PER_SECOND;
+}
+
+static unsigned long long mulHi(unsigned long long a, unsigned long long b) {
+#if defined(__SIZEOF_INT128__)
+    return (unsigned long long) (((unsigned __int128) a * b) >> 64);
+#else
+    unsigned long long aLo = a & 0xffffffffULL, aHi = a >> 32;
+    unsigned long long bLo = b & 0xffffffffULL, bHi = b >> 32;
+    unsigned long long ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    unsigned long long mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// Turns advanced over |dt| ticks, modulo one turn.
+static unsigned long long advance(const struct PhaseAccumulator* p, Tick dt) {
+    unsigned long long n = (dt < 0) ? 0ULL - (unsigned long long) dt : (unsigned long long) dt;
+    unsigned long long turns = p->rateHi * n + mulHi(p->rateLo, n);
+    return (dt < 0) ? 0ULL - turns : turns;
+}
+
+void initPhase(struct PhaseAccumulator* p, double omega, double phase) {
+    double turns = phase / (2 * M_PI);
+    turns -= floor(turns);
+    // A tiny negative phase rounds up to a whole turn, which 64 bits can't hold.
+    if (turns >= 1) { turns = 0; }
+    p->baseTick = 0;
+    p->baseTurns = (unsigned long long) ldexp(turns, 64);
+    p->rateHi = 0;
+    p->rateLo = 0;
+    setPhaseRate(p, omega, 0);
+}
+
+// Changes omega (>= 0) from tick on, keeping the phase continuous there.
+void setPhaseRate(struct PhaseAccumulator* p, double omega, Tick tick) {
+    p->baseTurns = phaseTurns(p, tick);
+    p->baseTick = tick;
+
+    // omega * TURN_SCALE in double-double, then split into integer and
+    // fractional 2^-64 turns per tick.
+    double hi = omega * TURN_SCALE_HI;
+    double lo = fma(omega, TURN_SCALE_HI, - hi) + omega * TURN_SCALE_LO;
+    double whole = floor(hi);
+    double frac = (hi - whole) + lo;
+    if (frac < 0) {
+        frac += 1;
+        whole -= 1;
+    }
+    // Also catches a tiny negative fraction that rounded up to 1 above.
+    if (frac >= 1) {
+        frac -= 1;
+        whole += 1;
+    }
+    p->rateHi = (unsigned long long) whole;
+    p->rateLo = (unsigned long long) ldexp(frac, 64);
+}
+
+unsigned long long phaseTurns(const struct PhaseAccumulator* p, Tick tick) {
+    return p->baseTurns + advance(p, tick - p->baseTick);
+}
+
+// Phase in [0, 2 pi).
+double phaseAt(const struct PhaseAccumulator* p, Tick tick) {
+    return phaseTurns(p, tick) * TWO_PI_OVER_2_64;
+}
@@ -0,0 +1,34 @@
+#ifndef PHASE_HPP
+#define PHASE_HPP
+
+// Integer-tick simulation timeline and a fixed-point phase accumulator.
+//
+// Simulation time is a signed count of nanosecond ticks. Phase is kept in
+// turns as an unsigned 64-bit fraction, so wrapping modulo 2 pi is the natural
+// integer overflow and never loses precision. The rate is stored with 64 more
+// fractional bits, which keeps omega * t exact to the last bit of the 64-bit
+// phase for far longer than weeks of ticks. Conversions saturate at
+// +-TICK_MAX rather than overflow. phaseAt() costs two integer
+// multiplies and a conversion, however long the run.
+
+typedef long long Tick;
+
+#define TICKS_PER_SECOND 1000000000LL
+#define TICK_MAX (1LL << 62)    // about 146 years; the sum of two still fits
+
+struct PhaseAccumulator {
+    Tick baseTick;
+    unsigned long long baseTurns;   // phase at baseTick, in 2^-64 turns
+    unsigned long long rateHi;      // 2^-64 turns per tick
+    unsigned long long rateLo;      // further 2^-128 turns per tick
+};
+
+Tick ticksFromSeconds(double seconds);
+double secondsFromTicks(Tick tick);
+
+void initPhase(struct PhaseAccumulator* p, double omega, double phase);
+void setPhaseRate(struct PhaseAccumulator* p, double omega, Tick tick);
+unsigned long long phaseTurns(const struct PhaseAccumulator* p, Tick tick);
+double phaseAt(const struct PhaseAccumulator* p, Tick tick);
+
+#endif // PHASE_HPP
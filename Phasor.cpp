@@ -0,0 +1,122 @@
+#include "Phasor.hpp"
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PHASOR_X86
+#endif
+
+// out[l] = re * offsetRe[l] - im * offsetIm[l] for l < n.
+typedef void (*BlockFn)(const float*, const float*, float, float, float*, int);
+
+static void blockScalar(const float* c, const float* s, float re, float im, float* out, int n) {
+    for (int l = 0; l < n; l++) {
+        out[l] = re * c[l] - im * s[l];
+    }
+}
+
+#ifdef PHASOR_X86
+
+static void blockSSE2(const float* c, const float* s, float re, float im, float* out, int n) {
+    __m128 r = _mm_set1_ps(re);
+    __m128 i = _mm_set1_ps(im);
+    int l = 0;
+    for (; l + 4 <= n; l += 4) {
+        __m128 x = _mm_sub_ps(_mm_mul_ps(r, _mm_loadu_ps(c + l)), _mm_mul_ps(i, _mm_loadu_ps(s + l)));
+        _mm_storeu_ps(out + l, x);
+    }
+    blockScalar(c + l, s + l, re, im, out + l, n - l);
+}
+
+__attribute__((target("avx2,fma")))
+static void blockAVX2(const float* c, const float* s, float re, float im, float* out, int n) {
+    __m256 r = _mm256_set1_ps(re);
+    __m256 i = _mm256_set1_ps(im);
+    int l = 0;
+    for (; l + 8 <= n; l += 8) {
+        __m256 x = _mm256_fmsub_ps(r, _mm256_loadu_ps(c + l), _mm256_mul_ps(i, _mm256_loadu_ps(s + l)));
+        _mm256_storeu_ps(out + l, x);
+    }
+    blockScalar(c + l, s + l, re, im, out + l, n - l);
+}
+
+__attribute__((target("avx512f")))
+static void blockAVX512(const float* c, const float* s, float re, float im, float* out, int n) {
+    __m512 r = _mm512_set1_ps(re);
+    __m512 i = _mm512_set1_ps(im);
+    int l = 0;
+    for (; l + 16 <= n; l += 16) {
+        __m512 x = _mm512_fmsub_ps(r, _mm512_loadu_ps(c + l), _mm512_mul_ps(i, _mm512_loadu_ps(s + l)));
+        _mm512_storeu_ps(out + l, x);
+    }
+    blockScalar(c + l, s + l, re, im, out + l, n - l);
+}
+
+#endif // PHASOR_X86
+
+static BlockFn selectKernel() {
+#ifdef PHASOR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { return blockAVX512; }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return blockAVX2; }
+    return blockSSE2;
+#else
+    return blockScalar;
+#endif
+}
+
+static BlockFn kernel = selectKernel();
+
+void initPhasor(struct Phasor* p, float amplitude, double omega, double phase0, double dt) {
+    // The offsets by recurrence in double, whose rounding stays far below
+    // the float table's over one block, rather than two trig calls each.
+    double stepRe = cos(omega * dt);
+    double stepIm = sin(omega * dt);
+    double re = 1;
+    double im = 0;
+    for (int l = 0; l < PHASOR_BLOCK; l++) {
+        p->offsetRe[l] = re;
+        p->offsetIm[l] = im;
+        double r = re * stepRe - im * stepIm;
+        im = re * stepIm + im * stepRe;
+        re = r;
+    }
+    p->re = cos(phase0);
+    p->im = sin(phase0);
+    p->rotRe = cos(omega * dt * PHASOR_BLOCK);
+    p->rotIm = sin(omega * dt * PHASOR_BLOCK);
+    p->amplitude = amplitude;
+    p->lane = 0;
+    p->blocks = 0;
+}
+
+static void advance(struct Phasor* p) {
+    double re = p->re * p->rotRe - p->im * p->rotIm;
+    double im = p->re * p->rotIm + p->im * p->rotRe;
+    if (++p->blocks == PHASOR_RENORM) {
+        // One Newton step towards 1 / |z|, enough since |z| stays within 1e-12 of 1.
+        double g = 1.5 - 0.5 * (re * re + im * im);
+        re *= g;
+        im *= g;
+        p->blocks = 0;
+    }
+    p->re = re;
+    p->im = im;
+}
+
+// Picks up mid-block where the previous call stopped.
+void phasorFill(struct Phasor* p, float* out, int n) {
+    int i = 0;
+    while (i < n) {
+        int m = PHASOR_BLOCK - p->lane;
+        if (m > n - i) { m = n - i; }
+        kernel(p->offsetRe + p->lane, p->offsetIm + p->lane,
+            p->amplitude * p->re, p->amplitude * p->im, out + i, m);
+        i += m;
+        p->lane += m;
+        if (p->lane == PHASOR_BLOCK) {
+            p->lane = 0;
+            advance(p);
+        }
+    }
+}
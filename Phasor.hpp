@@ -0,0 +1,30 @@
+#ifndef PHASOR_HPP
+#define PHASOR_HPP
+
+#define PHASOR_BLOCK 256
+#define PHASOR_RENORM 1024
+
+// Generates A * cos(phase0 + omega * dt * n) for consecutive n without a trig
+// call per sample. A double phasor e^{i phase} marks the start of each block
+// of PHASOR_BLOCK samples and is advanced by one complex multiply per block;
+// within a block, sample l is Re(z * e^{i omega dt l}) against a float table
+// of those offsets, so the samples are independent of each other and the
+// block loop is two packed multiplies per vector. The kernel is picked at
+// runtime like sinCosArray()'s. The phasor is renormalized every
+// PHASOR_RENORM blocks so rounding cannot make the trace grow or decay.
+struct Phasor {
+    float offsetRe[PHASOR_BLOCK];
+    float offsetIm[PHASOR_BLOCK];
+    double re;
+    double im;
+    double rotRe;
+    double rotIm;
+    double amplitude;
+    int lane;
+    int blocks;
+};
+
+void initPhasor(struct Phasor* p, float amplitude, double omega, double phase0, double dt);
+void phasorFill(struct Phasor* p, float* out, int n);
+
+#endif // PHASOR_HPP
@@ -0,0 +1,159 @@
+#include "Physics.hpp"
+#include "Journal.hpp"
+#include <chrono>
+
+// The part of a command that changes the simulation, applied at tick. The
+// engine is brought up to tick first, so what follows never depends on when
+// the physics thread happened to run; replay goes through here too.
+void simulateCommand(struct Engine* e, const struct Command* c, Tick tick) {
+    stepEngine(e, secondsFromTicks(tick));
+    switch (c->type) {
+        case SET_PARAMS:
+            setParams(e, &c->params);
+            stepEngine(e, secondsFromTicks(tick));
+            break;
+        case SEEK:
+            stepEngine(e, c->value);
+            break;
+        case SET_PHYSICS_RATE:
+            e->dt = c->value;
+            break;
+    }
+}
+
+// Returns false if the command had no effect. A seek is rewritten to the
+// exact time the clock landed on.
+static bool applyCommand(struct Engine* e, struct Command* c, Tick tick) {
+    switch (c->type) {
+        case SET_PAUSED:
+            if (c->value) { e->clock.pause(); }
+            else { e->clock.resume(); }
+            break;
+        case SEEK:
+            if (e->clock.isRunning()) { return false; }
+            e->clock.add(sf::microseconds((sf::Int64) (c->value * 1e6)) - e->clock.getElapsedTime());
+            c->value = secondsFromTicks(engineTick(e));
+            break;
+        case SET_TIME_SCALE:
+            e->clock.getClock().setScale(c->value);
+            break;
+    }
+    simulateCommand(e, c, tick);
+    return true;
+}
+
+// Fills s from the engine, which must already be stepped to tick.
+void fillSnapshot(struct Engine* e, Tick tick, struct Snapshot* s) {
+    struct Model m = engineModel(e);
+    s->tick = tick;
+    s->published = std::chrono::steady_clock::now();
+    // A clock held back by catchUpEngine() runs slower than its scale; the
+    // render thread then shows the snapshots as they come.
+    s->timeScale = e->limited ? 0 : e->clock.getClock().getScale();
+    s->running = e->clock.isRunning();
+    captureMotion(e, &s->motion);
+    s->params = e->params;
+    s->method = activeMethod(e);
+    s->regime = e->solution.regime;
+    s->energy0 = e->energy0;
+    s->energy = energy(&m, &e->state);
+    s->stepCost = e->stepCost;
+    s->substeps = isImplicit((enum Method) e->params.method) ? explicitSubsteps(&m, e->dt) : 1;
+    s->steps = e->adaptive.steps;
+    s->rejected = e->adaptive.rejected;
+    s->measuredPeriod = e->measuredPeriod;
+    s->limited = e->limited;
+}
+
+// Steps the engine to the current simulation time and fills s from it.
+static void snapshotEngine(struct Physics* p, struct Snapshot* s) {
+    Tick tick = catchUpEngine(&p->engine, engineTick(&p->engine));
+    fillSnapshot(&p->engine, tick, s);
+    s->serial = ++p->serial;
+}
+
+static void physicsLoop(struct Physics* p) {
+    struct Engine* e = &p->engine;
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+    while (p->running.load(std::memory_order_acquire)) {
+        struct Command c;
+        bool applied = false;
+        while (p->commands.pop(c)) {
+            Tick tick = catchUpEngine(e, engineTick(e));
+            if (!applyCommand(e, &c, tick)) { continue; }
+            if (p->journal) { recordCommand(p->journal, tick, &c); }
+            applied = true;
+        }
+
+        // The clock stops at the end of representable time, before anything
+        // downstream of it can overflow.
+        if (e->clock.isRunning() && engineTick(e) == TICK_MAX) {
+            e->clock.pause();
+            applied = true;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!e->clock.isRunning()) {
+            if (applied) {
+                snapshotEngine(p, &p->snapshots.back());
+                p->snapshots.publish();
+            }
+            next = now + PHYSICS_IDLE;
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        snapshotEngine(p, &p->snapshots.back());
+        p->snapshots.publish();
+
+        // Fixed cadence; after an overrun, start over from now rather than
+        // running a burst of iterations to catch up.
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(e->dt));
+        if (next < now) { next = now; }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+// Publishes a first snapshot, so the render thread has one before the
+// physics thread's first iteration.
+void initPhysics(struct Physics* p) {
+    initEngine(&p->engine);
+    p->serial = 0;
+    p->journal = NULL;
+    p->running = false;
+    snapshotEngine(p, &p->snapshots.back());
+    p->snapshots.publish();
+    p->snapshots.update();
+}
+
+void startPhysics(struct Physics* p) {
+    p->running.store(true, std::memory_order_release);
+    p->thread = std::thread(physicsLoop, p);
+}
+
+void stopPhysics(struct Physics* p) {
+    p->running.store(false, std::memory_order_release);
+    if (p->thread.joinable()) { p->thread.join(); }
+    if (p->journal) { p->journal->end = engineTick(&p->engine); }
+}
+
+// Render thread only. Returns false, dropping the command, if the queue is full.
+bool postCommand(struct Physics* p, const struct Command* c) {
+    return p->commands.push(*c);
+}
+
+// Render thread only. The snapshot stays valid until the next call.
+const struct Snapshot* latestSnapshot(struct Physics* p) {
+    p->snapshots.update();
+    return &p->snapshots.front();
+}
+
+// The simulation tick at wall time now: the snapshot's own while the clock is
+// stopped, otherwise carried on from it at the clock's rate.
+Tick snapshotTick(const struct Snapshot* s, std::chrono::steady_clock::time_point now) {
+    if (!s->running || now <= s->published) { return s->tick; }
+    std::chrono::duration<double> since = now - s->published;
+    Tick tick = s->tick + ticksFromSeconds(since.count() * s->timeScale);
+    return (tick < TICK_MAX) ? tick : TICK_MAX;
+}
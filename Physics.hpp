@@ -0,0 +1,85 @@
+#ifndef PHYSICS_HPP
+#define PHYSICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Engine.hpp"
+#include "TripleBuffer.hpp"
+#include "SpscQueue.hpp"
+
+// Runs the Engine on its own thread, one iteration every Engine::dt.
+//
+// Once startPhysics() returns, the Engine belongs to the physics thread. The
+// render thread only posts Commands, which are applied at the start of the
+// next iteration, and reads the latest published Snapshot. Neither side takes
+// a lock, so a slow frame never holds up the simulation and vice versa.
+//
+// While the clock is paused nothing changes between iterations, so the
+// thread only publishes after applying a command and otherwise polls the
+// queue every PHYSICS_IDLE.
+
+#define PHYSICS_QUEUE 256
+#define PHYSICS_IDLE std::chrono::milliseconds(10)
+
+enum CommandType {
+    SET_PARAMS,
+    SET_PAUSED,
+    SEEK,
+    SET_PHYSICS_RATE,
+    SET_TIME_SCALE
+};
+
+struct Command {
+    int type;
+    struct Params params;   // SET_PARAMS
+    double value;           // the others: paused flag, seconds, dt or scale
+};
+
+// Everything the render thread shows, as of one instant of the simulation.
+// The mass itself is not evaluated here: the render thread places it at its
+// own frame time with snapshotTick() and evaluateMotion(), so it moves every
+// frame even when physics publishes less often than the display refreshes.
+struct Snapshot {
+    unsigned long long serial;  // changes with every publish
+    Tick tick;
+    std::chrono::steady_clock::time_point published;    // wall time of tick
+    double timeScale;
+    bool running;
+    struct Motion motion;
+    struct Params params;
+    int method;             // activeMethod(), after the closed-form fallback
+    int regime;
+    double energy0;
+    double energy;
+    double stepCost;
+    int substeps;           // explicit substeps matching dt, implicit methods
+    int steps;
+    int rejected;
+    double measuredPeriod;
+    bool limited;           // integration can't keep up with the time scale
+};
+
+struct Journal;
+
+struct Physics {
+    struct Engine engine;
+    TripleBuffer<struct Snapshot> snapshots;
+    SpscQueue<struct Command, PHYSICS_QUEUE> commands;
+    unsigned long long serial;
+    struct Journal* journal;    // records applied commands if set before start
+    std::atomic<bool> running;
+    std::thread thread;
+};
+
+void simulateCommand(struct Engine* e, const struct Command* c, Tick tick);
+void fillSnapshot(struct Engine* e, Tick tick, struct Snapshot* s);
+
+void initPhysics(struct Physics* p);
+void startPhysics(struct Physics* p);
+void stopPhysics(struct Physics* p);
+bool postCommand(struct Physics* p, const struct Command* c);
+const struct Snapshot* latestSnapshot(struct Physics* p);
+Tick snapshotTick(const struct Snapshot* s, std::chrono::steady_clock::time_point now);
+
+#endif // PHYSICS_HPP
@@ -0,0 +1,297 @@
+#include "Plot.hpp"
+#include <cmath>
+
+static void strokePair(struct Plot* p, sf::Vector2f at, sf::Vector2f u) {
+    p->vertices[p->used++] = sf::Vertex(at + u, sf::Color(0, 148, 255));
+    p->vertices[p->used++] = sf::Vertex(at - u, sf::Color(0, 148, 255));
+}
+
+// Turns the cross-section at `at` from u0 to u1, angle radians apart.
+static void strokeJoin(struct Plot* p, sf::Vector2f at, sf::Vector2f u0, sf::Vector2f u1, float angle) {
+    int wedges = ceilf(fabsf(angle) / JOIN_STEP);
+    if (wedges > 1) {
+        float s = sinf(angle / wedges);
+        float c = cosf(angle / wedges);
+        sf::Vector2f u = u0;
+        for (int i = 1; i < wedges; i++) {
+            u = sf::Vector2f(u.x * c - u.y * s, u.x * s + u.y * c);
+            strokePair(p, at, u);
+        }
+    }
+    strokePair(p, at, u1);
+}
+
+void initPlot(struct Plot* p) {
+    initTrace(&p->trace);
+    p->vertices.resize(PLOT_VERTICES);
+    p->vertex.assign(TRACE_CAPACITY, 0);
+    p->buffer.setPrimitiveType(sf::TriangleStrip);
+    p->buffer.setUsage(sf::VertexBuffer::Stream);
+    p->gpu = sf::VertexBuffer::isAvailable() && p->buffer.create(PLOT_VERTICES);
+    p->viewEnd = 0;
+    p->span = 1;
+    p->scale = PLOT_RIGHT;
+    clearPlot(p);
+}
+
+void clearPlot(struct Plot* p) {
+    clearTrace(&p->trace);
+    p->stale = true;
+}
+
+// Shows the span seconds up to end. Only a new span re-tessellates, to keep
+// the stroke TRACE_WIDTH pixels wide.
+void setPlotView(struct Plot* p, Tick end, double span) {
+    p->viewEnd = end;
+    if (span != p->span) {
+        p->span = span;
+        p->scale = PLOT_RIGHT / span;
+        p->stale = true;
+    }
+}
+
+// A tick before the newest sample means time was set back, and starts the
+// history over; a repeated one adds nothing.
+void plotSample(struct Plot* p, Tick tick, float y) {
+    struct Trace* tr = &p->trace;
+    if (tr->count) {
+        Tick newest = tr->tick[traceSlot(tr, tr->count - 1)];
+        if (tick == newest) { return; }
+        if (tick < newest) { clearPlot(p); }
+    }
+    pushSample(tr, tick, y);
+}
+
+// refillTrace() for the plot's trace.
+float* refillPlot(struct Plot* p, Tick start, Tick step, int n) {
+    p->stale = true;
+    return refillTrace(&p->trace, start, step, n);
+}
+
+// Extends the strip to q with a round join, or starts it with a round cap.
+static void strokeTo(struct Plot* p, struct Pen* pen, sf::Vector2f q) {
+    float w = TRACE_WIDTH / 2.f;
+    if (!pen->started) {
+        pen->normal = sf::Vector2f(0, w);
+        strokePair(p, q, pen->normal);
+        strokeJoin(p, q, pen->normal, - pen->normal, HALF_TURN);
+        pen->normal = - pen->normal;
+        pen->last = q;
+        pen->started = true;
+        pen->bar = false;
+        return;
+    }
+
+    sf::Vector2f d = q - pen->last;
+    float len = sqrtf(d.x * d.x + d.y * d.y);
+    if (len < 1e-3f) { return; }
+    sf::Vector2f m(- d.y * w / len, d.x * w / len);
+    // Nearly straight joins need no wedges, and no trig.
+    float dot = pen->normal.x * m.x + pen->normal.y * m.y;
+    float cross = pen->normal.x * m.y - pen->normal.y * m.x;
+    float angle = dot > w * w * cosf(JOIN_STEP) ? 0 : atan2f(cross, dot);
+    strokeJoin(p, pen->last, pen->normal, m, angle);
+    strokePair(p, q, m);
+    pen->normal = m;
+    pen->last = q;
+    pen->bar = false;
+}
+
+// Screen-space point of a column's i-th summary sample.
+static sf::Vector2f columnPoint(const struct Plot* p, const struct Column* c, int i) {
+    float w = TRACE_WIDTH / 2.f;
+    return sf::Vector2f(secondsFromTicks(c->tick[i] - p->base) * p->scale + w, PLOT_BASELINE - c->value[i] + w);
+}
+
+// A column of one sample is a point of the line. Several samples in one
+// pixel column are drawn as a single vertical cross-section from the highest
+// to the lowest, two vertices joined to the neighbouring columns by plain
+// quads, which covers every segment between them.
+static void strokeColumn(struct Plot* p, struct Pen* pen, const struct Column* c) {
+    if (!c->count) { return; }
+    if (c->count == 1 || !pen->started) {
+        strokeTo(p, pen, columnPoint(p, c, 0));
+        if (c->count == 1) { return; }
+    }
+
+    float w = TRACE_WIDTH / 2.f;
+    float top = PLOT_BASELINE - c->value[2];
+    float bottom = PLOT_BASELINE - c->value[1] + 2 * w;
+    float side = pen->normal.y < 0 ? -1 : 1;
+    if (!pen->bar) {
+        // Turn the line's cross-section upright first, keeping its sides.
+        sf::Vector2f up(0, side * w);
+        float dot = pen->normal.x * up.x + pen->normal.y * up.y;
+        float cross = pen->normal.x * up.y - pen->normal.y * up.x;
+        strokeJoin(p, pen->last, pen->normal, up, atan2f(cross, dot));
+    }
+    strokePair(p, sf::Vector2f(c->x + 0.5f + w, (top + bottom) / 2), sf::Vector2f(0, side * (bottom - top) / 2));
+    pen->last = columnPoint(p, c, 3);
+    pen->normal = sf::Vector2f(0, side * w);
+    pen->bar = true;
+}
+
+// Tick at the plot's left edge, less a stroke width.
+static Tick viewStart(const struct Plot* p) {
+    return p->viewEnd - ticksFromSeconds(p->span + TRACE_WIDTH / p->scale);
+}
+
+// Index of the last sample left of the plot, whose segment into it is still
+// drawn.
+static int firstInView(const struct Plot* p) {
+    int i = findTick(&p->trace, viewStart(p));
+    return i > 0 ? i - 1 : 0;
+}
+
+// Serial of the oldest sample the strip has to hold: the first one in view,
+// but none more than PLOT_MAX_X / 2 px before the newest, so re-basing stays
+// rare, and no more than are sure to fit.
+static long long strokeStart(const struct Plot* p) {
+    const struct Trace* tr = &p->trace;
+    if (!tr->count) { return tr->first; }
+    Tick newest = tr->tick[traceSlot(tr, tr->count - 1)];
+    int i = firstInView(p);
+    int precise = findTick(tr, newest - ticksFromSeconds(PLOT_MAX_X / 2 / p->scale));
+    int fit = tr->count - (PLOT_VERTICES / PLOT_POINT_VERTICES - 9);
+    if (i < precise) { i = precise; }
+    if (i < fit) { i = fit; }
+    return tr->first + i;
+}
+
+// Adds a sample to the open column, stroking the open one first if the
+// sample lands past it.
+static void foldSample(struct Plot* p, Tick tick, float value) {
+    long long x = floor(secondsFromTicks(tick - p->base) * p->scale);
+    if (p->open.count && x != p->open.x) {
+        p->used = p->committed;
+        strokeColumn(p, &p->pen, &p->open);
+        p->committed = p->used;
+        p->open.count = 0;
+    }
+    p->open.x = x;
+    addToColumn(&p->open, tick, value);
+}
+
+// How far back the strip should reach: to the view's start, but never more
+// than PLOT_MAX_X / 2 px before the newest sample.
+static Tick strokeReach(const struct Plot* p) {
+    const struct Trace* tr = &p->trace;
+    Tick limit = tr->tick[traceSlot(tr, tr->count - 1)] - ticksFromSeconds(PLOT_MAX_X / 2 / p->scale);
+    Tick start = viewStart(p);
+    return start > limit ? start : limit;
+}
+
+// Whether the strip falls short of the view while older history is held,
+// in the archive or in ring samples strokeStart() left out.
+static bool needsPrefix(const struct Plot* p) {
+    const struct Trace* tr = &p->trace;
+    if (!tr->count) { return false; }
+    Tick oldest = tr->archiveCount ? tr->archive[0].tick[0] : tr->tick[tr->head];
+    return oldest < p->reach && strokeReach(p) < p->reach;
+}
+
+// Starts the strip over at the front of the buffer. If the view reaches back
+// further than strokeStart(), the history before it is folded in first, up
+// to PLOT_PREFIX vertices: archived columns, then the ring's samples before
+// strokeStart(), neither of which drawPlot() can start within.
+static void restartStroke(struct Plot* p) {
+    const struct Trace* tr = &p->trace;
+    long long first = strokeStart(p);
+    p->base = tr->count ? tr->tick[serialSlot(tr, first)] : 0;
+    p->reach = p->base;
+    p->origin = first;
+    p->next = first;
+    p->committed = 0;
+    p->used = 0;
+    p->open.count = 0;
+    p->pen.started = false;
+    p->stale = false;
+    if (!needsPrefix(p)) { return; }
+
+    // The column or sample before the reach too, for the segment into it,
+    // unless that is far enough back to spoil the precision.
+    p->reach = strokeReach(p);
+    Tick back = p->reach - ticksFromSeconds(PLOT_MAX_X / 4 / p->scale);
+    int c = findColumn(tr, p->reach);
+    if (c > 0 && tr->archive[c - 1].tick[0] >= back) { c--; }
+    int i = findTick(tr, p->reach);
+    if (i > 0 && tr->tick[traceSlot(tr, i - 1)] >= back) { i--; }
+    if (c < tr->archiveCount) { p->base = tr->archive[c].tick[0]; }
+    else if (i < first - tr->first) { p->base = tr->tick[traceSlot(tr, i)]; }
+
+    for (; c < tr->archiveCount && p->committed + PLOT_ROOM <= PLOT_PREFIX; c++) {
+        // A summary's points, in time order and each once.
+        const struct Column* col = &tr->archive[c];
+        int low = col->tick[1] <= col->tick[2] ? 1 : 2;
+        int order[4] = { 0, low, 3 - low, 3 };
+        Tick last = col->tick[0] - 1;
+        for (int k = 0; k < 4; k++) {
+            if (col->tick[order[k]] == last) { continue; }
+            last = col->tick[order[k]];
+            foldSample(p, last, col->value[order[k]]);
+        }
+    }
+    for (; i < first - tr->first && p->committed + PLOT_ROOM <= PLOT_PREFIX; i++) {
+        int slot = traceSlot(tr, i);
+        foldSample(p, tr->tick[slot], tr->value[slot]);
+    }
+}
+
+// Folds the samples added since the last call into their columns, strokes
+// the columns they closed, and uploads those vertices with the open column
+// and a new end cap.
+void updatePlot(struct Plot* p) {
+    const struct Trace* tr = &p->trace;
+    long long newest = tr->first + tr->count;
+    // Panning back past the strip's start rebuilds it from further back; a
+    // view reaching past the ring is drawn from the strip's start, which is
+    // rebuilt once that lies a plot width behind.
+    if (p->stale || p->next < tr->first || strokeStart(p) < p->origin || needsPrefix(p) ||
+        (!firstInView(p) && p->reach < viewStart(p) - ticksFromSeconds(PLOT_RIGHT / p->scale)) ||
+        (tr->count && secondsFromTicks(tr->tick[traceSlot(tr, tr->count - 1)] - p->base) * p->scale > PLOT_MAX_X)) {
+        restartStroke(p);
+    }
+    if (p->next == newest) { return; }
+
+    int from = p->committed;
+    while (p->next < newest) {
+        if (p->committed + PLOT_ROOM > PLOT_VERTICES) {
+            restartStroke(p);
+            from = 0;
+        }
+        int slot = serialSlot(tr, p->next);
+        foldSample(p, tr->tick[slot], tr->value[slot]);
+        p->vertex[slot] = p->committed;
+        p->next++;
+    }
+
+    p->used = p->committed;
+    struct Pen pen = p->pen;
+    strokeColumn(p, &pen, &p->open);
+    strokeJoin(p, pen.last, pen.normal, - pen.normal, HALF_TURN);
+
+    if (p->gpu) { p->buffer.update(&p->vertices[from], p->used - from, from); }
+}
+
+// One draw call from the last sample left of the plot on, through a view
+// that puts viewEnd at PLOT_RIGHT and clips to the plot area.
+void drawPlot(struct Plot* p, sf::RenderTarget* target) {
+    const struct Trace* tr = &p->trace;
+    if (!tr->count || p->stale) { return; }
+    // A view reaching back past the ring, or past the strip's first sample
+    // in it, is drawn from the strip's start: archived or evicted samples.
+    int i = firstInView(p);
+    long long first = tr->first + i;
+    int start = (!i || first <= p->origin) ? 0 : p->vertex[serialSlot(tr, first)];
+    if (start >= p->used) { return; }
+
+    sf::Vector2f size = target->getDefaultView().getSize();
+    float left = secondsFromTicks(p->viewEnd - p->base) * p->scale - PLOT_RIGHT;
+    sf::View view(sf::FloatRect(left, 0, PLOT_RIGHT + TRACE_WIDTH, size.y));
+    view.setViewport(sf::FloatRect(0, 0, (PLOT_RIGHT + TRACE_WIDTH) / size.x, 1));
+    sf::View previous = target->getView();
+    target->setView(view);
+    if (p->gpu) { target->draw(p->buffer, start, p->used - start); }
+    else { target->draw(&p->vertices[start], p->used - start, sf::TriangleStrip); }
+    target->setView(previous);
+}
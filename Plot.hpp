@@ -0,0 +1,85 @@
+#ifndef PLOT_HPP
+#define PLOT_HPP
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "Trace.hpp"
+
+// The graph: a Trace of samples and its thick-line stroke, kept on the GPU.
+//
+// Samples are tessellated once, into a single triangle strip laid out in
+// simulation time: a sample at tick t sits at x = (t - base) * scale pixels.
+// Which stretch of it is shown is only an sf::View, mapping the span seconds
+// up to the view's end tick onto the plot area and clipping the rest, so
+// scrolling, pausing and panning within the strip never touch a vertex. A
+// frame uploads only the vertices of the samples added since the last one,
+// over the end cap they replace. The buffer fills front to back; when it
+// runs out, the zoom changes, x outgrows PLOT_MAX_X or the view is panned
+// back past the strip's start, the strip is tessellated again from the front,
+// starting at the view but never more than PLOT_MAX_X / 2 px behind the
+// newest sample. That amortizes to a constant per sample.
+//
+// Samples pass through M4 decimation on the way: each pixel column of the
+// strip keeps only its first, lowest, highest and last sample, which draws
+// the same pixels as all of them. A view reaching back past the Trace's ring
+// starts the strip from its archive instead, whose summaries fold into pixel
+// columns the same way, so a long span shows its whole width. A column of several samples is stroked as
+// one upright cross-section spanning its lowest to highest, two vertices, so
+// however long the span a view holds a bounded number of vertices per
+// column. The column still being filled is stroked with the end cap, and
+// committed once a sample lands past it.
+//
+// Each sample contributes its cross-section pair (p + u, p - u). At a join
+// the pair is turned from the incoming to the outgoing normal in wedges of at
+// most JOIN_STEP; every vertex stays on the circle around the join, so both
+// sides come out round without knowing which one is outer. The ends are
+// capped by turning the pair through half a turn.
+
+#define PLOT_VERTICES (1 << 20)
+#define PLOT_POINT_VERTICES 24      // bound per point: a join and its pair
+#define PLOT_ROOM (9 * PLOT_POINT_VERTICES) // a column, the open one and a cap
+#define PLOT_PREFIX (PLOT_VERTICES / 4)     // bound on history before the ring
+#define PLOT_MAX_X (1 << 20)        // px of strip before re-basing
+#define PLOT_RIGHT 800              // screen x of the view's end tick
+#define PLOT_BASELINE 360
+#define TRACE_WIDTH 5
+#define HALF_TURN 3.14159265f
+#define JOIN_STEP (HALF_TURN / 8)   // widest wedge of a round join
+
+// Where the strip has got to: its newest point and cross-section half-vector.
+struct Pen {
+    sf::Vector2f last;
+    sf::Vector2f normal;
+    bool started;
+    bool bar;       // last drawn a column's cross-section
+};
+
+struct Plot {
+    struct Trace trace;
+    Tick viewEnd;                       // tick at the right edge of the plot
+    double span;                        // seconds across the plot
+    double scale;                       // px per second
+    std::vector<sf::Vertex> vertices;   // CPU copy of the buffer
+    std::vector<int> vertex;            // per trace slot: where its column starts
+    sf::VertexBuffer buffer;
+    bool gpu;                           // false draws from vertices instead
+    Tick base;                          // tick at x = 0, where the strip starts
+    Tick reach;                         // how far back it was asked to start
+    long long origin;                   // oldest serial in the buffer
+    long long next;                     // oldest serial not tessellated yet
+    int committed;                      // vertices of the closed columns
+    int used;                           // vertices in use
+    struct Column open;
+    struct Pen pen;                     // after the closed columns
+    bool stale;
+};
+
+void initPlot(struct Plot* p);
+void clearPlot(struct Plot* p);
+void setPlotView(struct Plot* p, Tick end, double span);
+void plotSample(struct Plot* p, Tick tick, float y);
+float* refillPlot(struct Plot* p, Tick start, Tick step, int n);
+void updatePlot(struct Plot* p);
+void drawPlot(struct Plot* p, sf::RenderTarget* target);
+
+#endif // PLOT_HPP
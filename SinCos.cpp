@@ -0,0 +1,230 @@
+#include "SinCos.hpp"
+#include "Oscillator.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SINCOS_X86
+#endif
+
+// The reduction runs in double: PIO2_1 has 33 significant bits so q * PIO2_1
+// is exact for |q| < 2^20, and PIO2_1T carries the rest of pi/2. The reduced
+// angle is then rounded to float once and fed to cephes minimax polynomials
+// on [-pi/4, pi/4].
+#define TWO_OVER_PI 6.36619772367581382433e-01
+#define PIO2_1 1.57079632673412561417e+00
+#define PIO2_1T 6.07710050650619224932e-11
+#define S0 -1.9515295891e-4f
+#define S1 8.3321608736e-3f
+#define S2 -1.6666654611e-1f
+#define C0 2.443315711809948e-5f
+#define C1 -1.388731625493765e-3f
+#define C2 4.166664568298827e-2f
+
+typedef void (*SinCosFn)(const float*, float*, float*, int);
+
+static void sinCosScalar(const float* phase, float* s, float* c, int n) {
+    for (int i = 0; i < n; i++) {
+        sinCos(phase[i], &s[i], &c[i]);
+    }
+}
+
+#ifdef SINCOS_X86
+
+static inline __m128d reduceHalfSSE2(__m128d x, __m128i* q) {
+    *q = _mm_cvtpd_epi32(_mm_mul_pd(x, _mm_set1_pd(TWO_OVER_PI)));
+    __m128d fq = _mm_cvtepi32_pd(*q);
+    __m128d r = _mm_sub_pd(x, _mm_mul_pd(fq, _mm_set1_pd(PIO2_1)));
+    return _mm_sub_pd(r, _mm_mul_pd(fq, _mm_set1_pd(PIO2_1T)));
+}
+
+static inline __m128 reduceSSE2(__m128 x, __m128i* q) {
+    __m128i qlo, qhi;
+    __m128d rlo = reduceHalfSSE2(_mm_cvtps_pd(x), &qlo);
+    __m128d rhi = reduceHalfSSE2(_mm_cvtps_pd(_mm_movehl_ps(x, x)), &qhi);
+    *q = _mm_unpacklo_epi64(qlo, qhi);
+    return _mm_movelh_ps(_mm_cvtpd_ps(rlo), _mm_cvtpd_ps(rhi));
+}
+
+static void sinCosSSE2(const float* phase, float* s, float* c, int n) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 limit = _mm_set1_ps(SINCOS_MAX_PHASE);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(phase + i);
+        if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_and_ps(x, absMask), limit))) {
+            sinCosScalar(phase + i, s + i, c + i, 4);
+            continue;
+        }
+
+        __m128i q;
+        __m128 r = reduceSSE2(x, &q);
+        __m128 z = _mm_mul_ps(r, r);
+
+        __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(S0), z), _mm_set1_ps(S1));
+        ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(S2));
+        ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), r), r);
+
+        __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(C0), z), _mm_set1_ps(C1));
+        pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(C2));
+        pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+        pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.f));
+
+        __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+        __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+        __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+
+        __m128 rs = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+        __m128 rc = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+        _mm_storeu_ps(s + i, _mm_xor_ps(rs, sinSign));
+        _mm_storeu_ps(c + i, _mm_xor_ps(rc, cosSign));
+    }
+    sinCosScalar(phase + i, s + i, c + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d reduceHalfAVX2(__m256d x, __m128i* q) {
+    *q = _mm256_cvtpd_epi32(_mm256_mul_pd(x, _mm256_set1_pd(TWO_OVER_PI)));
+    __m256d fq = _mm256_cvtepi32_pd(*q);
+    __m256d r = _mm256_fnmadd_pd(fq, _mm256_set1_pd(PIO2_1), x);
+    return _mm256_fnmadd_pd(fq, _mm256_set1_pd(PIO2_1T), r);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256 reduceAVX2(__m256 x, __m256i* q) {
+    __m128i qlo, qhi;
+    __m256d rlo = reduceHalfAVX2(_mm256_cvtps_pd(_mm256_castps256_ps128(x)), &qlo);
+    __m256d rhi = reduceHalfAVX2(_mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)), &qhi);
+    *q = _mm256_set_m128i(qhi, qlo);
+    return _mm256_set_m128(_mm256_cvtpd_ps(rhi), _mm256_cvtpd_ps(rlo));
+}
+
+__attribute__((target("avx2,fma")))
+static void sinCosAVX2(const float* phase, float* s, float* c, int n) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 limit = _mm256_set1_ps(SINCOS_MAX_PHASE);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(phase + i);
+        if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_and_ps(x, absMask), limit, _CMP_GT_OQ))) {
+            sinCosScalar(phase + i, s + i, c + i, 8);
+            continue;
+        }
+
+        __m256i q;
+        __m256 r = reduceAVX2(x, &q);
+        __m256 z = _mm256_mul_ps(r, r);
+
+        __m256 ps = _mm256_fmadd_ps(_mm256_set1_ps(S0), z, _mm256_set1_ps(S1));
+        ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(S2));
+        ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, z), r, r);
+
+        __m256 pc = _mm256_fmadd_ps(_mm256_set1_ps(C0), z, _mm256_set1_ps(C1));
+        pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(C2));
+        pc = _mm256_mul_ps(_mm256_mul_ps(pc, z), z);
+        pc = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, pc), _mm256_set1_ps(1.f));
+
+        __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+        __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+        __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+
+        _mm256_storeu_ps(s + i, _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap), sinSign));
+        _mm256_storeu_ps(c + i, _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap), cosSign));
+    }
+    sinCosScalar(phase + i, s + i, c + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d reduceHalfAVX512(__m512d x, __m256i* q) {
+    *q = _mm512_cvtpd_epi32(_mm512_mul_pd(x, _mm512_set1_pd(TWO_OVER_PI)));
+    __m512d fq = _mm512_cvtepi32_pd(*q);
+    __m512d r = _mm512_fnmadd_pd(fq, _mm512_set1_pd(PIO2_1), x);
+    return _mm512_fnmadd_pd(fq, _mm512_set1_pd(PIO2_1T), r);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512 reduceAVX512(const float* x, __m512i* q) {
+    __m256i qlo, qhi;
+    __m512d rlo = reduceHalfAVX512(_mm512_cvtps_pd(_mm256_loadu_ps(x)), &qlo);
+    __m512d rhi = reduceHalfAVX512(_mm512_cvtps_pd(_mm256_loadu_ps(x + 8)), &qhi);
+    *q = _mm512_inserti64x4(_mm512_castsi256_si512(qlo), qhi, 1);
+    __m256i flo = _mm256_castps_si256(_mm512_cvtpd_ps(rlo));
+    __m256i fhi = _mm256_castps_si256(_mm512_cvtpd_ps(rhi));
+    return _mm512_castsi512_ps(_mm512_inserti64x4(_mm512_castsi256_si512(flo), fhi, 1));
+}
+
+__attribute__((target("avx512f")))
+static void sinCosAVX512(const float* phase, float* s, float* c, int n) {
+    const __m512 limit = _mm512_set1_ps(SINCOS_MAX_PHASE);
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i two = _mm512_set1_epi32(2);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 x = _mm512_loadu_ps(phase + i);
+        if (_mm512_cmp_ps_mask(_mm512_abs_ps(x), limit, _CMP_GT_OQ)) {
+            sinCosScalar(phase + i, s + i, c + i, 16);
+            continue;
+        }
+
+        __m512i q;
+        __m512 r = reduceAVX512(phase + i, &q);
+        __m512 z = _mm512_mul_ps(r, r);
+
+        __m512 ps = _mm512_fmadd_ps(_mm512_set1_ps(S0), z, _mm512_set1_ps(S1));
+        ps = _mm512_fmadd_ps(ps, z, _mm512_set1_ps(S2));
+        ps = _mm512_fmadd_ps(_mm512_mul_ps(ps, z), r, r);
+
+        __m512 pc = _mm512_fmadd_ps(_mm512_set1_ps(C0), z, _mm512_set1_ps(C1));
+        pc = _mm512_fmadd_ps(pc, z, _mm512_set1_ps(C2));
+        pc = _mm512_mul_ps(_mm512_mul_ps(pc, z), z);
+        pc = _mm512_add_ps(_mm512_fnmadd_ps(_mm512_set1_ps(0.5f), z, pc), _mm512_set1_ps(1.f));
+
+        __mmask16 swap = _mm512_test_epi32_mask(q, one);
+        __m512i sinSign = _mm512_slli_epi32(_mm512_and_si512(q, two), 30);
+        __m512i cosSign = _mm512_slli_epi32(_mm512_and_si512(_mm512_add_epi32(q, one), two), 30);
+
+        __m512 rs = _mm512_mask_blend_ps(swap, ps, pc);
+        __m512 rc = _mm512_mask_blend_ps(swap, pc, ps);
+        _mm512_storeu_ps(s + i, _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(rs), sinSign)));
+        _mm512_storeu_ps(c + i, _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(rc), cosSign)));
+    }
+    sinCosScalar(phase + i, s + i, c + i, n - i);
+}
+
+#endif // SINCOS_X86
+
+static SinCosFn selectKernel(const char** name) {
+#ifdef SINCOS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        *name = "avx512";
+        return sinCosAVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        *name = "avx2";
+        return sinCosAVX2;
+    }
+    *name = "sse2";
+    return sinCosSSE2;
+#else
+    *name = "scalar";
+    return sinCosScalar;
+#endif
+}
+
+static const char* kernelName = "";
+static SinCosFn kernel = selectKernel(&kernelName);
+
+void sinCosArray(const float* phase, float* s, float* c, int n) {
+    kernel(phase, s, c, n);
+}
+
+const char* sinCosKernel() {
+    return kernelName;
+}
@@ -0,0 +1,20 @@
+#ifndef SINCOS_HPP
+#define SINCOS_HPP
+
+// Bulk sine/cosine over arrays of phases.
+//
+// The kernel is picked once at runtime from the host CPU: AVX-512F, AVX2+FMA
+// or SSE2, with a scalar loop on other targets. Every kernel uses the same
+// Cody-Waite reduction to [-pi/4, pi/4] and minimax polynomials, and stays
+// within SINCOS_MAX_ULP of the correctly rounded result for
+// |phase| <= SINCOS_MAX_PHASE. Lanes outside that range fall back to libm.
+//
+// c may alias phase; s may not.
+
+#define SINCOS_MAX_ULP 2
+#define SINCOS_MAX_PHASE 100000.f
+
+void sinCosArray(const float* phase, float* s, float* c, int n);
+const char* sinCosKernel();
+
+#endif // SINCOS_HPP
@@ -0,0 +1,41 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded wait-free queue for exactly one producer and one consumer thread.
+// N must be a power of two. push() fails instead of blocking when full.
+template <typename T, int N>
+class SpscQueue
+{
+public:
+    SpscQueue() : m_head(0), m_tail(0)
+    {
+    }
+
+    bool push(const T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == N) { return false; }
+        m_items[head & (N - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) { return false; }
+        item = m_items[tail & (N - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T m_items[N];
+    alignas(64) std::atomic<size_t> m_head;    // written by the producer
+    alignas(64) std::atomic<size_t> m_tail;    // written by the consumer
+};
+
+#endif // SPSCQUEUE_HPP
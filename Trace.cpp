@@ -0,0 +1,154 @@
+#include "Trace.hpp"
+#include <cstddef>
+
+void initTrace(struct Trace* tr) {
+    tr->tick.assign(TRACE_CAPACITY, 0);
+    tr->value.assign(TRACE_CAPACITY, 0);
+    tr->archive.resize(ARCHIVE_CAPACITY);
+    clearTrace(tr);
+}
+
+static void clearArchive(struct Trace* tr) {
+    tr->archiveCount = 0;
+    tr->bucket = ARCHIVE_BUCKET;
+}
+
+void clearTrace(struct Trace* tr) {
+    tr->head = 0;
+    tr->count = 0;
+    tr->first = 0;
+    clearArchive(tr);
+}
+
+void addToColumn(struct Column* c, Tick tick, float value) {
+    if (!c->count) {
+        for (int i = 0; i < 4; i++) {
+            c->tick[i] = tick;
+            c->value[i] = value;
+        }
+    } else {
+        if (value < c->value[1]) {
+            c->tick[1] = tick;
+            c->value[1] = value;
+        }
+        if (value > c->value[2]) {
+            c->tick[2] = tick;
+            c->value[2] = value;
+        }
+        c->tick[3] = tick;
+        c->value[3] = value;
+    }
+    c->count++;
+}
+
+// Folds the later column b into a.
+static void mergeColumn(struct Column* a, const struct Column* b) {
+    if (b->value[1] < a->value[1]) {
+        a->tick[1] = b->tick[1];
+        a->value[1] = b->value[1];
+    }
+    if (b->value[2] > a->value[2]) {
+        a->tick[2] = b->tick[2];
+        a->value[2] = b->value[2];
+    }
+    a->tick[3] = b->tick[3];
+    a->value[3] = b->value[3];
+    a->count += b->count;
+}
+
+// Halves the archive's resolution in place, oldest first.
+static void coarsenArchive(struct Trace* tr) {
+    int kept = 0;
+    for (int i = 0; i < tr->archiveCount; i++) {
+        struct Column c = tr->archive[i];
+        c.x >>= 1;
+        struct Column* last = kept ? &tr->archive[kept - 1] : NULL;
+        if (last && last->x == c.x) { mergeColumn(last, &c); }
+        else { tr->archive[kept++] = c; }
+    }
+    tr->archiveCount = kept;
+    tr->bucket *= 2;
+}
+
+static void archiveSample(struct Trace* tr, Tick tick, float value) {
+    long long x = tick / tr->bucket - (tick < 0 && tick % tr->bucket);
+    struct Column* last = tr->archiveCount ? &tr->archive[tr->archiveCount - 1] : NULL;
+    if (last && last->x == x) {
+        addToColumn(last, tick, value);
+        return;
+    }
+    if (tr->archiveCount == ARCHIVE_CAPACITY) {
+        // Sparse columns may not pair up at once; free half so this is rare.
+        while (tr->archiveCount > ARCHIVE_CAPACITY / 2) { coarsenArchive(tr); }
+        archiveSample(tr, tick, value);
+        return;
+    }
+    struct Column* c = &tr->archive[tr->archiveCount++];
+    c->x = x;
+    c->count = 0;
+    addToColumn(c, tick, value);
+}
+
+// A full ring hands its oldest sample to the archive.
+void pushSample(struct Trace* tr, Tick tick, float value) {
+    int slot = (tr->head + tr->count) & (TRACE_CAPACITY - 1);
+    if (tr->count == TRACE_CAPACITY) {
+        archiveSample(tr, tr->tick[slot], tr->value[slot]);
+    }
+    tr->tick[slot] = tick;
+    tr->value[slot] = value;
+    if (tr->count < TRACE_CAPACITY) { tr->count++; }
+    else {
+        tr->head = (tr->head + 1) & (TRACE_CAPACITY - 1);
+        tr->first++;
+    }
+}
+
+// Replaces the history with n <= TRACE_CAPACITY samples stamped start,
+// start + step, ... and returns their values, contiguous from slot 0, for the
+// caller to fill.
+float* refillTrace(struct Trace* tr, Tick start, Tick step, int n) {
+    clearArchive(tr);
+    tr->head = 0;
+    tr->count = n;
+    tr->first = 0;
+    for (int i = 0; i < n; i++) {
+        tr->tick[i] = start + step * i;
+    }
+    return tr->value.data();
+}
+
+// Storage slot of the i-th oldest sample.
+int traceSlot(const struct Trace* tr, int i) {
+    return (tr->head + i) & (TRACE_CAPACITY - 1);
+}
+
+// Storage slot of the sample with the given serial, which must still be held.
+int serialSlot(const struct Trace* tr, long long serial) {
+    return traceSlot(tr, (int) (serial - tr->first));
+}
+
+// Index of the oldest sample at or after tick, or count if there is none.
+int findTick(const struct Trace* tr, Tick tick) {
+    int lo = 0;
+    int hi = tr->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (tr->tick[traceSlot(tr, mid)] < tick) { lo = mid + 1; }
+        else { hi = mid; }
+    }
+    return lo;
+}
+
+// Index of the oldest archived column ending at or after tick, or
+// archiveCount if there is none.
+int findColumn(const struct Trace* tr, Tick tick) {
+    int lo = 0;
+    int hi = tr->archiveCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (tr->archive[mid].tick[3] < tick) { lo = mid + 1; }
+        else { hi = mid; }
+    }
+    return lo;
+}
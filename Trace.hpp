@@ -0,0 +1,56 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <vector>
+#include "Phase.hpp"
+
+// The graph's history: a fixed-capacity ring of timestamped samples.
+//
+// Storage is allocated once by initTrace(); pushing a sample overwrites the
+// oldest one when full, so the per-frame cost is one store per array however
+// long the history is. Ticks never decrease from one sample to the next, so
+// a time can be found by bisection. Ticks and values are kept in separate
+// arrays so a batch of values can be generated straight into place.
+//
+// Samples pushed out of the ring are not lost but folded into an archive of
+// M4 column summaries, each covering `bucket` ticks. When the archive fills,
+// neighbouring columns are merged pairwise and the bucket doubles, so it
+// holds the whole history since the last clear at a resolution that only
+// coarsens as the history grows: hours of it in ARCHIVE_CAPACITY columns.
+
+#define TRACE_CAPACITY (1 << 16)    // power of two
+#define ARCHIVE_CAPACITY (1 << 14)
+#define ARCHIVE_BUCKET (TICKS_PER_SECOND / 1000)    // before any merge
+
+// The M4 summary of a column of samples: its first, lowest, highest and last
+// sample. x is the column's index.
+struct Column {
+    long long x;
+    int count;
+    Tick tick[4];
+    float value[4];
+};
+
+struct Trace {
+    std::vector<Tick> tick;
+    std::vector<float> value;
+    int head;       // slot of the oldest sample
+    int count;
+    long long first;    // serial of the oldest sample since the last clear
+
+    std::vector<struct Column> archive; // oldest first; x is tick / bucket
+    int archiveCount;
+    Tick bucket;
+};
+
+void initTrace(struct Trace* tr);
+void clearTrace(struct Trace* tr);
+void pushSample(struct Trace* tr, Tick tick, float value);
+float* refillTrace(struct Trace* tr, Tick start, Tick step, int n);
+int traceSlot(const struct Trace* tr, int i);
+int serialSlot(const struct Trace* tr, long long serial);
+int findTick(const struct Trace* tr, Tick tick);
+void addToColumn(struct Column* c, Tick tick, float value);
+int findColumn(const struct Trace* tr, Tick tick);
+
+#endif // TRACE_HPP
@@ -0,0 +1,51 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <atomic>
+
+// Lock-free handoff of the latest value from one writer thread to one reader
+// thread. The writer fills back() and publish()es it; the reader calls
+// update() and reads front(). Neither side ever waits: the two swap slots
+// through a shared middle index, and a slot is never touched by both at once.
+// Values the reader did not pick up in time are simply overwritten.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : m_middle(1), m_back(0), m_front(2)
+    {
+    }
+
+    T& back()
+    {
+        return m_slots[m_back];
+    }
+
+    void publish()
+    {
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Returns true if front() changed.
+    bool update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) { return false; }
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& front() const
+    {
+        return m_slots[m_front];
+    }
+
+private:
+    enum { INDEX = 3, FRESH = 4 };
+
+    T m_slots[3];
+    std::atomic<int> m_middle;  // slot index, plus FRESH once published
+    int m_back;                 // writer only
+    int m_front;                // reader only
+};
+
+#endif // TRIPLEBUFFER_HPP
@@ -0,0 +1,48 @@
+#ifndef VIRTUALCLOCK_HPP
+#define VIRTUALCLOCK_HPP
+
+#include <SFML/System/Clock.hpp>
+
+// Drop-in replacement for sf::Clock whose time runs at a multiple of wall
+// time. Changing the scale rebases on the current reading, so the virtual
+// time never jumps; only its rate changes from that instant on.
+class VirtualClock
+{
+public:
+    VirtualClock() : m_scale(1), m_base(sf::Time::Zero)
+    {
+    }
+
+    sf::Time getElapsedTime() const
+    {
+        double real = m_clock.getElapsedTime().asMicroseconds();
+        return m_base + sf::microseconds((sf::Int64) (real * m_scale));
+    }
+
+    sf::Time restart()
+    {
+        sf::Time time = getElapsedTime();
+        m_base = sf::Time::Zero;
+        m_clock.restart();
+        return time;
+    }
+
+    void setScale(double scale)
+    {
+        m_base = getElapsedTime();
+        m_clock.restart();
+        m_scale = scale;
+    }
+
+    double getScale() const
+    {
+        return m_scale;
+    }
+
+private:
+    sf::Clock m_clock;
+    double m_scale;
+    sf::Time m_base;
+};
+
+#endif // VIRTUALCLOCK_HPP
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include "Network.hpp"
+
+// Thread scaling of stepNetwork(): the same cloth stepped with 1 to N
+// threads, N the hardware concurrency unless given. Reports steps per
+// second, speedup and parallel efficiency against one thread. Every node is
+// computed the same way whatever the split, so the final positions must
+// match bit for bit; a mismatch fails the run.
+//
+//   bench_network [width] [height] [threads]
+
+#define BENCH_STEPS 200
+#define BENCH_DT (1.f / 2000)
+
+int main(int argc, char** argv) {
+    int w = argc > 1 ? atoi(argv[1]) : 500;
+    int h = argc > 2 ? atoi(argv[2]) : 500;
+    int most = argc > 3 ? atoi(argv[3]) : std::thread::hardware_concurrency();
+    if (w < 2 || h < 2 || most < 1) {
+        fprintf(stderr, "usage: bench_network [width] [height] [threads]\n");
+        return 2;
+    }
+
+    struct Network net;
+    initNetwork(&net, 1);
+    std::vector<float> reference;
+    double base = 0;
+    bool same = true;
+
+    printf("%d x %d cloth, %d springs, %d steps\n", w, h,
+        2 * w * h - w - h + 2 * (w - 1) * (h - 1), BENCH_STEPS);
+    printf("%8s %12s %10s %12s\n", "threads", "steps/s", "speedup", "efficiency");
+    for (int threads = 1; threads <= most; threads++) {
+        initCloth(&net, w, h, 0.25f, 200.f, 0.1f, threads);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int s = 0; s < BENCH_STEPS; s++) {
+            stepNetwork(&net, BENCH_DT);
+        }
+        std::chrono::duration<double> spent = std::chrono::steady_clock::now() - start;
+
+        double rate = BENCH_STEPS / spent.count();
+        if (threads == 1) {
+            base = rate;
+            reference = net.pos;
+        } else if (net.pos != reference) {
+            same = false;
+        }
+        printf("%8d %12.1f %10.2f %11.0f%%\n", threads, rate, rate / base, rate / base / threads * 100);
+    }
+    freeNetwork(&net);
+
+    if (!same) {
+        fprintf(stderr, "positions differ from the single-threaded run\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include "Oscillator.hpp"
+
+// Throughput of evaluateBank(): x, v and a for every oscillator of a bank of
+// 1k, 100k and 10M, with periods spread over 0.1 to 10 s. Each size is
+// evaluated at advancing t until BENCH_SECONDS have passed.
+//
+//   bench_oscillators [count ...]
+
+#define BENCH_SECONDS 0.5
+
+static void bench(int count) {
+    struct OscillatorBank b;
+    initBank(&b, count);
+    srand(1);
+    for (int i = 0; i < count; i++) {
+        setOscillatorPeriod(&b, i, 0.1f + 9.9f * rand() / RAND_MAX);
+        b.phi[i] = 6.28f * rand() / RAND_MAX;
+    }
+
+    evaluateBank(&b, 0);
+    long long passes = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> spent(0);
+    while (spent.count() < BENCH_SECONDS || passes < 3) {
+        evaluateBank(&b, passes * 0.001f);
+        passes++;
+        spent = std::chrono::steady_clock::now() - start;
+    }
+
+    // Keeps the last pass observable.
+    double sum = 0;
+    for (int i = 0; i < count; i += count / 16 + 1) { sum += b.x[i]; }
+
+    printf("%10d oscillators  %8lld passes  %8.1f M evaluations/s  (%g)\n",
+        count, passes, count * passes / spent.count() * 1e-6, sum);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) { bench(atoi(argv[i])); }
+    } else {
+        bench(1000);
+        bench(100000);
+        bench(10000000);
+    }
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include "Engine.hpp"
+#include "ParamModel.hpp"
+#include "Chain.hpp"
+
+// Batch entry point: runs the Engine with no window, ImGui or assets and
+// streams x, v and a at a fixed sample rate to a file, or with --chain the
+// displacement of every mass of a spring chain. Links against the SFML
+// system module only.
+
+#define HEADLESS_BUFFER (1 << 16)
+#define HEADLESS_CHUNK 0.5     // s; stepEngine() restarts on jumps over 1 s
+
+static const char* methodIds[METHOD_COUNT] = {
+    "analytic",
+    "euler",
+    "verlet",
+    "rk4",
+    "backward-euler",
+    "newmark",
+    "dopri"
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: headless [options] --out <file>\n"
+        "  --mass <kg>  --k <N/m>  --omega <rad/s>  --f <Hz>  --period <s>\n"
+        "  --xmax <m>  --phi <rad>  --damping <kg/s>  --drive <N>  --drive-omega <rad/s>\n"
+        "  --method analytic|euler|verlet|rk4|backward-euler|newmark|dopri\n"
+        "  --dt <s>         physics step of the fixed-step methods (0.001)\n"
+        "  --duration <s>   simulated time (10)\n"
+        "  --rate <Hz>      samples per simulated second (1000)\n"
+        "  --chain <n>      n masses of --mass between fixed walls, joined by\n"
+        "                   springs of --k, the first displaced by --xmax\n"
+        "  --format csv|binary\n"
+        "Frequency options are applied in order, as the options panel would.\n"
+        "Fixed-step methods report the step nearest each sample time.\n"
+        "binary writes native float32 x v a triples, or the n chain displacements,\n"
+        "sample i at t = i / rate.\n"
+        "--out - writes to stdout.\n");
+}
+
+static int methodFromId(const char* id) {
+    for (int m = 0; m < METHOD_COUNT; m++) {
+        if (!strcmp(id, methodIds[m])) { return m; }
+    }
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    struct Params params;
+    initParams(&params);
+    struct ParamModel model;
+    initParamModel(&model, &params);
+    double dt = 1.0 / 1000;
+    double duration = 10;
+    double rate = 1000;
+    bool binary = false;
+    int chainMasses = 0;
+    const char* outPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        if (i + 1 == argc) {
+            usage();
+            return 2;
+        }
+        const char* arg = argv[++i];
+        // Numbers stay double; the Params fields narrow them to float.
+        char* end;
+        double value = strtod(arg, &end);
+        bool number = end != arg && *end == '\0';
+        if (!number && strcmp(opt, "--method") && strcmp(opt, "--format") && strcmp(opt, "--out")) {
+            usage();
+            return 2;
+        }
+
+        if (!strcmp(opt, "--mass")) {
+            if (!setQuantity(&model, MASS, value)) {
+                fprintf(stderr, "mass must be positive\n");
+                return 2;
+            }
+        }
+        else if (!strcmp(opt, "--k")) { setQuantity(&model, STIFFNESS, value); }
+        else if (!strcmp(opt, "--omega")) { setQuantity(&model, OMEGA, value); }
+        else if (!strcmp(opt, "--f")) { setQuantity(&model, FREQUENCY, value); }
+        else if (!strcmp(opt, "--period")) { setQuantity(&model, PERIOD, value); }
+        else if (!strcmp(opt, "--xmax")) { params.Xmax = value; }
+        else if (!strcmp(opt, "--phi")) { params.phi = value; }
+        else if (!strcmp(opt, "--damping")) { params.damping = value; }
+        else if (!strcmp(opt, "--drive")) { params.driveForce = value; }
+        else if (!strcmp(opt, "--drive-omega")) { params.driveOmega = value; }
+        else if (!strcmp(opt, "--method")) {
+            params.method = methodFromId(arg);
+            if (params.method < 0) {
+                usage();
+                return 2;
+            }
+        }
+        else if (!strcmp(opt, "--dt")) { dt = value; }
+        else if (!strcmp(opt, "--duration")) { duration = value; }
+        else if (!strcmp(opt, "--rate")) { rate = value; }
+        else if (!strcmp(opt, "--chain")) {
+            if (!(value >= 0 && value <= 1e9) || value != (int) value) {
+                usage();
+                return 2;
+            }
+            chainMasses = value;
+        }
+        else if (!strcmp(opt, "--format")) {
+            if (strcmp(arg, "csv") && strcmp(arg, "binary")) {
+                usage();
+                return 2;
+            }
+            binary = !strcmp(arg, "binary");
+        }
+        else if (!strcmp(opt, "--out")) { outPath = arg; }
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (!outPath || !(dt > 0) || !(rate > 0) || !(duration >= 0) || chainMasses < 0) {
+        usage();
+        return 2;
+    }
+    modelParams(&model, &params);
+
+    FILE* out = strcmp(outPath, "-") ? fopen(outPath, "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "can't open %s\n", outPath);
+        return 1;
+    }
+
+    struct Engine e;
+    initEngine(&e);
+    setParams(&e, &params);
+    e.dt = dt;
+    stepEngine(&e, 0);
+    // Fixed-step methods are stepped half a step past each sample, so their
+    // last step is the one nearest it whatever the rounding of the grid.
+    int method = activeMethod(&e);
+    double lead = (method == ANALYTIC || method == DORMAND_PRINCE) ? 0 : dt / 2;
+
+    struct Chain chain;
+    if (chainMasses) {
+        initChain(&chain, chainMasses, params.mass, params.k, true, true);
+        std::vector<double> x0(chainMasses, 0);
+        std::vector<double> v0(chainMasses, 0);
+        x0[0] = params.Xmax;
+        setChainInitial(&chain, x0.data(), v0.data());
+        updateChain(&chain);
+    }
+
+    int width = chainMasses ? chainMasses : 3;
+    int rowBytes = 16 * (width + 1) + 2;
+    std::vector<char> buffer(rowBytes * 2 > HEADLESS_BUFFER ? rowBytes * 2 : HEADLESS_BUFFER);
+    std::vector<float> row(width);
+    int used = 0;
+    if (!binary && chainMasses) {
+        used = sprintf(buffer.data(), "t");
+        for (int m = 0; m < chainMasses; m++) {
+            if ((int) buffer.size() - used < rowBytes) {
+                fwrite(buffer.data(), 1, used, out);
+                used = 0;
+            }
+            used += sprintf(buffer.data() + used, ",x%d", m);
+        }
+        used += sprintf(buffer.data() + used, "\n");
+    } else if (!binary) {
+        used = sprintf(buffer.data(), "t,x,v,a\n");
+    }
+
+    long long count = (long long) (duration * rate) + 1;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double last = 0;
+    for (long long i = 0; i < count; i++) {
+        Tick tick = ticksFromSeconds(i / rate);
+        double t = secondsFromTicks(tick);
+        if (chainMasses) {
+            evaluateChain(&chain, t);
+            memcpy(row.data(), chain.x.data(), width * sizeof(float));
+        } else {
+            for (double c = last + HEADLESS_CHUNK; c < t; c += HEADLESS_CHUNK) {
+                stepEngine(&e, c + lead);
+            }
+            stepEngine(&e, t + lead);
+            last = t;
+            struct State st = integratedState(&e, tick);
+            row[0] = st.x;
+            row[1] = st.v;
+            row[2] = st.a;
+        }
+
+        if ((int) buffer.size() - used < rowBytes) {
+            fwrite(buffer.data(), 1, used, out);
+            used = 0;
+        }
+        if (binary) {
+            memcpy(buffer.data() + used, row.data(), width * sizeof(float));
+            used += width * sizeof(float);
+        } else {
+            used += sprintf(buffer.data() + used, "%.9g", t);
+            for (int v = 0; v < width; v++) {
+                used += sprintf(buffer.data() + used, ",%.9g", row[v]);
+            }
+            buffer[used++] = '\n';
+        }
+    }
+    fwrite(buffer.data(), 1, used, out);
+
+    bool ok = !ferror(out);
+    if (out != stdout) { ok = fclose(out) == 0 && ok; }
+    else { fflush(out); }
+    if (!ok) {
+        fprintf(stderr, "write to %s failed\n", outPath);
+        return 1;
+    }
+
+    std::chrono::duration<double> spent = std::chrono::steady_clock::now() - start;
+    if (chainMasses) {
+        fprintf(stderr, "%lld samples of a %d-mass chain in %.3f s (%.1f M samples/s)\n",
+            count, chainMasses, spent.count(), count / spent.count() * 1e-6);
+    } else {
+        fprintf(stderr, "%lld samples of %s in %.3f s (%.1f M samples/s)\n",
+            count, methodNames[method], spent.count(), count / spent.count() * 1e-6);
+    }
+    return 0;
+}
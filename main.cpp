@@ -1,50 +1,61 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <cmath>
+#include <cstring>
 #include <string>
 #include <vector>
-#include <list>
+#include <thread>
 #include "include/imgui.h"
 #include "include/imgui-SFML.h"
-#include "Chronometer.hpp"
-
-#define PI 3.14159265
-
-struct Engine {
-    float mass;
-    float k;
-    float omega;
-    float Xmax;
-    float period;
-    float phi;
-    sftools::Chronometer clock;
-    float graphSpeed;
-};
+#include "Engine.hpp"
+#include "Physics.hpp"
+#include "ParamModel.hpp"
+#include "Journal.hpp"
+#include "Network.hpp"
+#include "Plot.hpp"
+#include "FramePacer.hpp"
+
+// Frames still drawn after the last change, so ImGui can settle hover and
+// release states before the loop goes idle.
+#define IDLE_FRAMES 3
 
 struct Graphic {
     std::vector<sf::RectangleShape*> drawables;
-    std::list<sf::CircleShape*> graph;
+    struct Plot plot;
     std::vector<sf::Text*> hud;
+    sf::VertexArray mesh;
     sf::Font cascadia;
 };
 
-float pos(struct Engine* e);
-float x(struct Engine* e);
-float vel(struct Engine* e);
-float acc(struct Engine* e);
-float calcOmega(struct Engine* e);
-float calcPeriod(struct Engine* e);
-void setPeriod(struct Engine* e, struct Graphic* g, float period);
-void initEngine(struct Engine* e);
 void initSpring(struct Graphic* g);
 void initAxis(struct Graphic* g);
-void initHud(struct Engine* e, struct Graphic* g);
-void shiftGraph(struct Engine* e, struct Graphic* g);
-void graphPoint(struct Graphic* g, float y);
-void updateValues(struct Engine* e, struct Graphic* g);
+void initHud(struct Params* params, struct Graphic* g);
+bool dragQuantity(const char* label, struct ParamModel* m, int q, float max);
+void regenerateGraph(struct Graphic* g, const struct Params* p, double t, double span, double pan);
+void updateValues(const struct Snapshot* s, const struct State* st, Tick tick, struct Graphic* g);
+void meshNetwork(struct Network* net, struct Graphic* g);
 void render(sf::RenderWindow* window, struct Graphic* g);
 
-int main() {
+int main(int argc, char** argv) {
+    // --record <file> saves a journal of this session's input on exit;
+    // --replay <file> plays one back instead of running live.
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--record")) { recordPath = argv[++i]; }
+        else if (!strcmp(argv[i], "--replay")) { replayPath = argv[++i]; }
+    }
+
+    struct Journal journal;
+    struct Replay replay;
+    if (replayPath) {
+        if (!loadJournal(&journal, replayPath)) {
+            std::cerr << "can't read journal " << replayPath << std::endl;
+            return 1;
+        }
+        initReplay(&replay, &journal);
+    }
+
     double aspect_ratio = 16.0 / 9;
     int width = 1280;
     int height = int(width / aspect_ratio);
@@ -57,32 +68,70 @@ int main() {
     window_flags |= ImGuiWindowFlags_NoResize;
     window_flags |= ImGuiWindowFlags_NoCollapse;
     
-    struct Engine e;
+    struct Physics phys;
     struct Graphic g;
 
-    initEngine(&e);
+    // The panel edits its own copy of the parameters; the physics thread
+    // only sees them through SET_PARAMS commands.
+    initPhysics(&phys);
+    if (recordPath && !replayPath) {
+        initJournal(&journal, &phys.engine);
+        phys.journal = &journal;
+    }
+    struct Params params = replayPath ? journal.initial : phys.engine.params;
     initSpring(&g);
     initAxis(&g);
-    initHud(&e, &g);
+    initPlot(&g.plot);
+    initHud(&params, &g);
 
-    double dt = 1.f/60.f; // Modify this to change physics rate.
-    double accumulator = 0.f;
+    double dt = 1.f/60.f; // Frame interval when sleep-paced; physics steps at Engine::dt.
+    struct FramePacer pacer;
+    initPacer(&pacer, &window, dt, SLEEP);
+    int physicsRate = round(1 / phys.engine.dt);
     sf::Clock clock;
     sf::Clock clockImGui;
     sf::Clock fpsClk;
     unsigned int fps = 0;
 
     bool pause = true;
-    float period = e.period;
-    float omega = e.omega;
-    float mass = e.mass;
-    float k = e.k;
-    float f = e.omega / (2 * PI);
-    float simTime = e.clock.getElapsedTime().asSeconds();
+    bool paused = true;
+    bool edited = false;
+    bool showNetwork = false;
+    struct Network net;
+    initNetwork(&net, 1);
+    struct ParamModel model;
+    initParamModel(&model, &params);
+    float simTime = 0;
+    float timeScale = 1;
+    float graphPeriods = 2.5f;  // the graph's width, in periods
+    float graphPan = 0;         // s the graph's right edge lags behind
+    struct Command cmd;
+    const struct Snapshot* snap = latestSnapshot(&phys);
+    unsigned long long serial = snap->serial;
+    Tick shown = snap->tick;       // simulation time of the last frame
+    bool shownRunning = false;
+    int quiet = 0;
+    bool idle = false;
+    bool playing = false;
+    bool replayMoved = true;
+    bool scrubbed = false;
+    float replaySpeed = 1;
+    struct Snapshot replaySnap;
+    replaySnap.serial = 0;
+
+    if (!replayPath) { startPhysics(&phys); }
 
     while (window.isOpen()) {
+        // When idle, block until the next event instead of spinning frames.
         sf::Event event;
-        while (window.pollEvent(event)) {
+        bool woke = idle && window.waitEvent(event);
+        if (idle) {
+            idle = false;
+            resumePacer(&pacer);
+        }
+        while (woke || window.pollEvent(event)) {
+            woke = false;
+            quiet = 0;
             ImGui::SFML::ProcessEvent(window, event);
 
             if (event.type == sf::Event::Closed)
@@ -91,139 +140,199 @@ int main() {
 
         ImGui::SFML::Update(window, clockImGui.restart());
         ImGui::Begin("options", NULL, window_flags);
+        if (replayPath) {
+            if (ImGui::Checkbox("play", &playing)) { replayMoved = true; }
+            ImGui::SliderFloat("replay speed", &replaySpeed, 0.01f, 10000.f, "%.2fx", ImGuiSliderFlags_Logarithmic);
+            float at = secondsFromTicks(replay.tick);
+            if (ImGui::SliderFloat("replay time", &at, 0.f, secondsFromTicks(replay.horizon))) {
+                seekReplay(&replay, ticksFromSeconds(at));
+                replayMoved = true;
+                scrubbed = true;
+            }
+            ImGui::Text("input: %d / %d", replay.next, (int) journal.entries.size());
+        }
+        ImGui::BeginDisabled(replayPath != NULL);
         ImGui::Checkbox("pause", &pause);
+        ImGui::EndDisabled();
+        if (ImGui::Checkbox("network", &showNetwork) && showNetwork && !net.nodes) {
+            initCloth(&net, 48, 30, 0.25f, 200.f, 0.1f, std::thread::hardware_concurrency());
+        }
         ImGui::Text("<- -             + ->");
-        ImGui::DragFloat("x max", &e.Xmax, 0.1f, 0.f, 1000.f); // v
-        ImGui::DragFloat("w", &omega, 0.1f, 0.f, 1000.f); // v
-        ImGui::DragFloat("mass", &mass, 0.1f, 0.f, 1000.f); //
-        ImGui::DragFloat("k", &k, 0.1f, 0.f, 1000000.f);
-        ImGui::DragFloat("f", &f, 0.1f, 0.f, 1000.f);
-        ImGui::DragFloat("phi", &e.phi, 0.1f, - 2 * PI, 2 * PI);
-        ImGui::DragFloat("period", &period, 0.1f, 0.f, 1000.f);
-        ImGui::DragFloat("time", &simTime, 0.1f, 0.f, 1000.f);
+        ImGui::BeginDisabled(replayPath != NULL);
+        if (ImGui::Combo("method", &params.method, methodNames, METHOD_COUNT)) { edited = true; }
+        if (ImGui::DragFloat("x max", &params.Xmax, 0.1f, 0.f, 1000.f)) { edited = true; } // v
+        if (dragQuantity("w", &model, OMEGA, 1000.f)) { edited = true; } // v
+        float mass = model.value[MASS];
+        if (ImGui::DragFloat("mass", &mass, 0.1f, 0.f, 1000.f)) {
+            if (setQuantity(&model, MASS, mass)) { edited = true; }
+            else { pause = true; }
+        }
+        if (dragQuantity("k", &model, STIFFNESS, 1000000.f)) { edited = true; }
+        if (dragQuantity("f", &model, FREQUENCY, 1000.f)) { edited = true; }
+        if (ImGui::DragFloat("phi", &params.phi, 0.1f, - 2 * PI, 2 * PI)) { edited = true; }
+        if (ImGui::DragFloat("damping", &params.damping, 0.01f, 0.f, 1000.f)) { edited = true; }
+        if (ImGui::DragFloat("F drive", &params.driveForce, 0.1f, 0.f, 1000.f)) { edited = true; }
+        if (ImGui::DragFloat("w drive", &params.driveOmega, 0.1f, 0.f, 1000.f)) { edited = true; }
+        if (dragQuantity("period", &model, PERIOD, 1000.f)) { edited = true; }
+        bool seeking = ImGui::DragFloat("time", &simTime, 0.1f, 0.f, 1000000000.f);
+        if (ImGui::SliderInt("physics Hz", &physicsRate, 60, 10000)) {
+            cmd.type = SET_PHYSICS_RATE;
+            cmd.value = 1.0 / physicsRate;
+            postCommand(&phys, &cmd);
+        }
+        ImGui::EndDisabled();
+        if (ImGui::Combo("pacing", &pacer.mode, pacingNames, PACING_MODE_COUNT)) {
+            setPacingMode(&pacer, &window, pacer.mode);
+        }
+        ImGui::Text("frame: %.2f ms, jitter: %.3f ms", pacer.frameTime, pacer.jitter);
+        ImGui::BeginDisabled(replayPath != NULL);
+        if (ImGui::SliderFloat("time scale", &timeScale, 0.01f, 1000000.f, "%.2fx", ImGuiSliderFlags_Logarithmic)) {
+            cmd.type = SET_TIME_SCALE;
+            cmd.value = timeScale;
+            postCommand(&phys, &cmd);
+        }
+        ImGui::EndDisabled();
+        float span = graphPeriods * snap->params.period;
+        ImGui::SliderFloat("graph periods", &graphPeriods, 0.1f, 10000.f, "%.1f", ImGuiSliderFlags_Logarithmic);
+        ImGui::DragFloat("graph pan", &graphPan, span / PLOT_RIGHT, 0.f, 1000000000.f, "%.3f s");
+        if (snap->method == ANALYTIC) {
+            ImGui::Text("regime: %s", regimeNames[snap->regime]);
+        } else if (snap->energy0 > 0) {
+            ImGui::Text("E drift: %.3e", (snap->energy - snap->energy0) / snap->energy0);
+            ImGui::Text("step: %.0f ns", snap->stepCost);
+            if (snap->limited) {
+                ImGui::Text("behind: integration limits the time scale");
+            }
+            if (isImplicit((enum Method) snap->params.method)) {
+                ImGui::Text("explicit substeps: %d", snap->substeps);
+            }
+            if (snap->params.method == DORMAND_PRINCE) {
+                ImGui::Text("steps: %d (%d rejected)", snap->steps, snap->rejected);
+                ImGui::Text("T measured: %.9f s", snap->measuredPeriod);
+            }
+        }
         ImGui::End();
         ImGui::EndFrame();
 
-        accumulator += clock.getElapsedTime().asMicroseconds() / 1000000.f;
-        clock.restart();
-        if (accumulator >= dt) {
-            // Physics and stuff
-            if (period != e.period) {
-                setPeriod(&e, &g, period);
-                omega = e.omega;
-                k = e.k;
-                f = 1 / period;
-            } else if (omega != e.omega) {
-                setPeriod(&e, &g, 2 * PI / omega);
-                k = e.k;
-                period = e.period;
-                f = 1 / period;
-            } else if (mass != e.mass) {
-                if (mass) {
-                    e.mass = mass;
-                    setPeriod(&e, &g, 2 * PI / calcOmega(&e));
-                    omega = e.omega;
-                    period = e.period;
-                    f = 1 / period;
-                } else { pause = true; }
-            } else if (k != e.k) {
-                e.k = k;
-                setPeriod(&e, &g, 2 * PI / calcOmega(&e));
-                omega = e.omega;
-                period = e.period;
-                f = 1 / e.period;
-            } else if ( 1 / f != e.period) {
-                setPeriod(&e, &g, 1 / f);
-                omega = e.omega;
-                period = e.period;
-                k = e.k;
-            } else if (!e.clock.isRunning()) {
-                float curTime = e.clock.getElapsedTime().asSeconds();
-                if (simTime != curTime) {
-                    e.clock.add(sf::seconds(simTime - curTime));
-                }
+        // Real time since the last frame, capped so a stall can't explode the cloth.
+        double frame = clock.restart().asSeconds();
+        if (frame > 0.1) { frame = 0.1; }
+
+        // Replay drives the view from its own engine instead of the physics thread.
+        if (replayPath) {
+            if (playing) {
+                playing = playReplay(&replay, ticksFromSeconds(frame * replaySpeed));
+                replayMoved = true;
             }
-            simTime = e.clock.getElapsedTime().asSeconds();
-
-            updateValues(&e, &g);
-            g.drawables[1]->setSize(sf::Vector2f(g.drawables[1]->getSize().x, 216 - pos(&e)));
-            g.drawables[2]->setPosition(g.drawables[2]->getPosition().x, 360 - pos(&e));
-            g.drawables[9]->setPosition(g.drawables[9]->getPosition().x, 362 - pos(&e));
-
-            if (!pause) {
-                e.clock.resume();
-                if (e.omega != 0) {
-                    graphPoint(&g, g.drawables[2]->getPosition().y);
-                    shiftGraph(&e, &g);
-                }
+            if (replayMoved) {
+                fillSnapshot(&replay.engine, replay.tick, &replaySnap);
+                replaySnap.running = playing;
+                replaySnap.timeScale = replaySpeed;
+                replaySnap.serial++;
+                params = replaySnap.params;
+                initParamModel(&model, &params);
+                replayMoved = false;
+            }
+            if (scrubbed) {
+                regenerateGraph(&g, &params, secondsFromTicks(replay.tick), graphPeriods * params.period, graphPan);
+                scrubbed = false;
+            }
+            pause = !playing;
+            paused = pause;
+            snap = &replaySnap;
+        } else {
+            if (seeking && pause) {
+                cmd.type = SEEK;
+                cmd.value = simTime;
+                postCommand(&phys, &cmd);
+                regenerateGraph(&g, &params, simTime, graphPeriods * params.period, graphPan);
+            }
+
+            // A full queue keeps the edit pending for the next frame.
+            if (edited) {
+                modelParams(&model, &params);
+                cmd.type = SET_PARAMS;
+                cmd.params = params;
+                edited = !postCommand(&phys, &cmd);
+            }
+            if (pause != paused) {
+                cmd.type = SET_PAUSED;
+                cmd.value = pause;
+                if (postCommand(&phys, &cmd)) { paused = pause; }
             }
-            else { e.clock.pause(); }
 
-            accumulator = 0;
+            snap = latestSnapshot(&phys);
+        }
 
-            fps++;
-            render(&window, &g);
-            ImGui::SFML::Render(window);
-            window.display();
+        bool changed = snap->serial != serial;
+        serial = snap->serial;
+
+        // The mass is placed at this frame's simulation time, not the
+        // snapshot's; never behind the last frame while the clock runs, so
+        // the graph only grows.
+        Tick tick = snapshotTick(snap, std::chrono::steady_clock::now());
+        if (snap->running && shownRunning && tick < shown) { tick = shown; }
+        shown = tick;
+        shownRunning = snap->running;
+        struct State st = evaluateMotion(&snap->motion, tick);
+        if ((changed || snap->running) && !seeking) { simTime = secondsFromTicks(tick); }
+
+        // Nothing moved and nobody touched anything: skip the HUD, the draw
+        // calls and the present, and wait for input.
+        if (changed || snap->running || edited || seeking || pause != paused || (showNetwork && !pause) || ImGui::IsAnyItemActive()) {
+            quiet = 0;
+        } else if (++quiet > IDLE_FRAMES) {
+            idle = true;
+            continue;
         }
 
+        updateValues(snap, &st, tick, &g);
+        g.drawables[1]->setSize(sf::Vector2f(g.drawables[1]->getSize().x, 216 - st.screenPos));
+        g.drawables[2]->setPosition(g.drawables[2]->getPosition().x, 360 - st.screenPos);
+        g.drawables[9]->setPosition(g.drawables[9]->getPosition().x, 362 - st.screenPos);
+
+        if (!pause) {
+            if (snap->params.omega != 0) {
+                plotSample(&g.plot, tick, st.screenPos);
+            }
+            if (showNetwork) {
+                int substeps = ceil(frame * physicsRate);
+                for (int s = 0; s < substeps; s++) {
+                    stepNetwork(&net, frame / substeps);
+                }
+                parkNetwork(&net);
+            }
+        }
+
+        if (snap->params.omega != 0) {
+            setPlotView(&g.plot, tick - ticksFromSeconds(graphPan), graphPeriods * snap->params.period);
+        }
+        updatePlot(&g.plot);
+        if (showNetwork) { meshNetwork(&net, &g); }
+        else { g.mesh.clear(); }
+
+        fps++;
+        render(&window, &g);
+        ImGui::SFML::Render(window);
+        window.display();
+        waitFrame(&pacer);
+
         if (fpsClk.getElapsedTime().asMilliseconds() >= 1000) {
             fpsClk.restart();
             std::cout << fps << std::endl;
             fps = 0;
         }
     }
+    stopPhysics(&phys);
+    freeNetwork(&net);
+    if (recordPath && !replayPath && !saveJournal(&journal, recordPath)) {
+        std::cerr << "can't write journal " << recordPath << std::endl;
+    }
     ImGui::SFML::Shutdown();
 
     return 0;
 }
 
-float pos(struct Engine* e) {
-    float t = e->clock.getElapsedTime().asMilliseconds() / 1000.f;
-    return (((e->Xmax > 4) ? 4 : e->Xmax) * 50) * cosf(e->omega * t + e->phi);
-}
-
-float x(struct Engine* e) {
-    float t = e->clock.getElapsedTime().asMilliseconds() / 1000.f;
-    return e->Xmax * cosf(e->omega * t + e->phi);
-}
-
-float vel(struct Engine* e) {
-    float t = e->clock.getElapsedTime().asMilliseconds() / 1000.f;
-    return - e->omega * e->Xmax * sinf(e->omega * t + e->phi);
-}
-
-float acc(struct Engine* e) {
-    float t = e->clock.getElapsedTime().asMilliseconds() / 1000.f;
-    return e->omega * e->omega * e->Xmax * cosf(e->omega * t + e->phi);
-}
-
-float calcOmega(struct Engine* e) {
-    return sqrtf(e->k / e->mass);
-}
-
-float calcPeriod(struct Engine* e) {
-    return 2 * PI * sqrtf(e->mass / e->k);
-}
-
-void setPeriod(struct Engine* e, struct Graphic* g, float period) {
-    e->period = period;
-    e->omega = 2 * PI / period;
-    e->k = e->omega * e->omega * e->mass;
-    e->graphSpeed = -5.f / e->period;
-}
-
-void initEngine(struct Engine* e) {
-    e->k = 1;
-    e->mass = 1;
-    e->Xmax = 1;
-    e->phi = 0;
-    e->period = 1;
-    e->omega = 2 * PI / e->period;
-    e->k = e->omega * e->omega * e->mass;
-    e->graphSpeed = -5;
-}
-
 void initSpring(struct Graphic* g) {
     sf::RectangleShape* ceiling = new sf::RectangleShape(sf::Vector2f(325, 23));
     ceiling->setOrigin(325/2-~(325&0x01), 23/2-~(23&0x01));
@@ -288,7 +397,7 @@ void initAxis(struct Graphic* g) {
     g->drawables.push_back(bar);
 }
 
-void initHud(struct Engine* e, struct Graphic* g) {
+void initHud(struct Params* params, struct Graphic* g) {
     g->cascadia.loadFromFile("CascadiaCode-Regular.otf");
 
     sf::Text* bar = new sf::Text;
@@ -298,7 +407,7 @@ void initHud(struct Engine* e, struct Graphic* g) {
     bar->setPosition(860, 350);
     g->hud.push_back(bar);
 
-    std::string s = std::to_string(e->Xmax);
+    std::string s = std::to_string(params->Xmax);
     s = s.substr(0, s.find('.') + 3);
 
     sf::Text* Xm = new sf::Text;
@@ -309,7 +418,7 @@ void initHud(struct Engine* e, struct Graphic* g) {
     Xm->setString("x max: " + s + " m");
     g->hud.push_back(Xm);
 
-    s = std::to_string(e->omega);
+    s = std::to_string(params->omega);
     s = s.substr(0, s.find('.') + 3);
 
     sf::Text* omega = new sf::Text;
@@ -320,7 +429,7 @@ void initHud(struct Engine* e, struct Graphic* g) {
     omega->setString("w: " + s + " rad/s");
     g->hud.push_back(omega);
 
-    s = std::to_string(e->mass);
+    s = std::to_string(params->mass);
     s = s.substr(0, s.find('.') + 3);
 
     sf::Text* m = new sf::Text;
@@ -331,7 +440,7 @@ void initHud(struct Engine* e, struct Graphic* g) {
     m->setString("m: " + s + " Kg");
     g->hud.push_back(m);
 
-    s = std::to_string(e->k);
+    s = std::to_string(params->k);
     s = s.substr(0, s.find('.') + 3);
 
     sf::Text* k = new sf::Text;
@@ -342,7 +451,7 @@ void initHud(struct Engine* e, struct Graphic* g) {
     k->setString("k: " + s + " N/m");
     g->hud.push_back(k);
 
-    s = std::to_string(e->omega / (2 * PI));
+    s = std::to_string(params->omega / (2 * PI));
     s = s.substr(0, s.find('.') + 3);
 
     sf::Text* f = new sf::Text;
@@ -353,7 +462,7 @@ void initHud(struct Engine* e, struct Graphic* g) {
     f->setString("f: " + s + " Hz");
     g->hud.push_back(f);
 
-    s = std::to_string(e->phi);
+    s = std::to_string(params->phi);
     s = s.substr(0, s.find('.') + 3);
 
     sf::Text* phi = new sf::Text;
@@ -364,7 +473,7 @@ void initHud(struct Engine* e, struct Graphic* g) {
     phi->setString("phi: " + s + " rad");
     g->hud.push_back(phi);
 
-    s = std::to_string((2 * PI) / e->omega);
+    s = std::to_string((2 * PI) / params->omega);
     s = s.substr(0, s.find('.') + 3);
 
     sf::Text* p = new sf::Text;
@@ -408,65 +517,85 @@ void initHud(struct Engine* e, struct Graphic* g) {
     g->hud.push_back(at);
 }
 
-void shiftGraph(struct Engine* e, struct Graphic* g) {
-    int lim = g->graph.size();
-    for (std::list<sf::CircleShape*>::iterator it = g->graph.begin(); it != g->graph.end(); it++) {
-        (*it)->move(e->graphSpeed, 0); // -2
-        if ((*it)->getPosition().x < -5) {
-            delete *it;
-            g->graph.erase(it);
-        }
-    }
+// A panel field backed by the parameter model; true once the edit has propagated.
+bool dragQuantity(const char* label, struct ParamModel* m, int q, float max) {
+    float value = m->value[q];
+    if (!ImGui::DragFloat(label, &value, 0.1f, 0.f, max)) { return false; }
+    return setQuantity(m, q, value);
 }
 
-void graphPoint(struct Graphic* g, float y) {
-    sf::CircleShape* p = new sf::CircleShape(2.5);
-    p->setFillColor(sf::Color(0, 148, 255));
-    p->setPosition(800, y);
-    g->graph.push_back(p);
+// Redraws the trace for time t straight from the closed form, span seconds
+// at one sample per pixel plus the pan seconds after it, so a seek shows the
+// right history at once instead of the old one.
+void regenerateGraph(struct Graphic* g, const struct Params* p, double t, double span, double pan) {
+    if (!(span > 0) || std::isinf(span)) {
+        clearPlot(&g->plot);
+        return;
+    }
+    Tick step = ticksFromSeconds(span / PLOT_RIGHT);
+    if (step <= 0) {
+        clearPlot(&g->plot);
+        return;
+    }
+    double samples = (span + pan) * PLOT_RIGHT / span + 1;
+    int n = samples > TRACE_CAPACITY ? TRACE_CAPACITY : samples;
+    Tick start = ticksFromSeconds(t) - step * (n - 1);
+    // Nothing happened before t = 0; damped closed forms blow up there.
+    if (start < 0) {
+        Tick skip = (- start + step - 1) / step;
+        start += skip * step;
+        n -= skip;
+    }
+    if (n <= 0) {
+        clearPlot(&g->plot);
+        return;
+    }
+    float* values = refillPlot(&g->plot, start, step, n);
+    if (!sampleTrace(p, start, step, values, n)) { clearPlot(&g->plot); }
 }
 
-void updateValues(struct Engine* e, struct Graphic* g) {
-    std::string s = std::to_string(x(e));
+void updateValues(const struct Snapshot* snap, const struct State* st, Tick tick, struct Graphic* g) {
+    const struct Params* p = &snap->params;
+    std::string s = std::to_string(st->x);
     s = s.substr(0, s.find('.') + 3);
     g->hud[0]->setString(s);
-    g->hud[0]->setPosition(860, 350 - pos(e));
+    g->hud[0]->setPosition(860, 350 - st->screenPos);
     g->hud[9]->setString("x(t): " + s + " m");
 
-    s = std::to_string(e->Xmax);
+    s = std::to_string(p->Xmax);
     s = s.substr(0, s.find('.') + 3);
     g->hud[1]->setString("x max: " + s + " m");
 
-    s = std::to_string(e->omega);
+    s = std::to_string(p->omega);
     s = s.substr(0, s.find('.') + 3);
     g->hud[2]->setString("w: " + s + " rad/s");
 
-    s = std::to_string(e->mass);
+    s = std::to_string(p->mass);
     s = s.substr(0, s.find('.') + 3);
     g->hud[3]->setString("m: " + s + " Kg");
 
-    s = std::to_string(e->k);
+    s = std::to_string(p->k);
     s = s.substr(0, s.find('.') + 3);
     g->hud[4]->setString("k: " + s + " N/m");
 
-    s = std::to_string(e->omega / (2 * PI));
+    s = std::to_string(p->omega / (2 * PI));
     s = s.substr(0, s.find('.') + 3);
     g->hud[5]->setString("f: " + s + " Hz");
 
-    s = std::to_string(e->phi);
+    s = std::to_string(p->phi);
     s = s.substr(0, s.find('.') + 3);
     g->hud[6]->setString("phi: " + s + " rad");
 
-    s = std::to_string((2 * PI) / e->omega);
+    s = std::to_string((2 * PI) / p->omega);
     s = s.substr(0, s.find('.') + 3);
     g->hud[7]->setString("T: " + s + " s");
 
-    unsigned int total = e->clock.getElapsedTime().asSeconds();
-    unsigned int hr = total / 3600;
+    long long total = tick / TICKS_PER_SECOND;
+    long long hr = total / 3600;
     total -= hr * 3600;
-    unsigned int min = total / 60;
+    long long min = total / 60;
     total -= min * 60;
-    unsigned int sec = total;
+    long long sec = total;
 
     s = "time: ";
     if (hr < 10) { s = s + "0"; }
@@ -477,15 +606,28 @@ void updateValues(struct Engine* e, struct Graphic* g) {
     s = s + std::to_string(sec);
     g->hud[8]->setString(s);
 
-    s = std::to_string(vel(e));
+    s = std::to_string(st->v);
     s = s.substr(0, s.find('.') + 3);
     g->hud[10]->setString("v(t): " + s + " m/s");
 
-    s = std::to_string(acc(e));
+    s = std::to_string(st->a);
     s = s.substr(0, s.find('.') + 3);
     g->hud[11]->setString("a(t): " + s + " m/s^2");
 }
 
+// One line pair per spring, drawn as a single batch over the plot area.
+void meshNetwork(struct Network* net, struct Graphic* g) {
+    int springs = net->springA.size();
+    g->mesh.setPrimitiveType(sf::Lines);
+    g->mesh.resize(2 * springs);
+    for (int s = 0; s < springs; s++) {
+        const float* a = &net->pos[3 * net->springA[s]];
+        const float* b = &net->pos[3 * net->springB[s]];
+        g->mesh[2 * s] = sf::Vertex(sf::Vector2f(100 + a[0] * 50, 100 + a[1] * 50), sf::Color(0, 148, 255));
+        g->mesh[2 * s + 1] = sf::Vertex(sf::Vector2f(100 + b[0] * 50, 100 + b[1] * 50), sf::Color(0, 148, 255));
+    }
+}
+
 void render(sf::RenderWindow* window, struct Graphic* g) {
     window->clear();
 
@@ -494,22 +636,10 @@ void render(sf::RenderWindow* window, struct Graphic* g) {
         window->draw(*(g->drawables)[i]);
     }
 
-    std::list<sf::CircleShape*>::iterator it2 = g->graph.begin();
-    it2++;
-    for (std::list<sf::CircleShape*>::iterator it = g->graph.begin(); it != g->graph.end(); it++, it2++) {
-        if (it2 != g->graph.end()) {
-            float dx = (*it2)->getPosition().x - (*it)->getPosition().x;
-            float dy = (*it2)->getPosition().y - (*it)->getPosition().y;
-            float dist = sqrtf((dx*dx) + (dy * dy));
-            float angle = atan2f(dy,dx) * 180 / PI;
-            sf::RectangleShape bridge(sf::Vector2f(dist, 5));
-            bridge.setPosition((*it)->getPosition().x + 2.5, (*it)->getPosition().y+2.5);
-            bridge.setFillColor(sf::Color(0, 148, 255));
-            bridge.setOrigin(0, 2.5);
-            bridge.setRotation(angle);
-            window->draw(bridge);
-        }
-        window->draw(**it);
+    drawPlot(&g->plot, window);
+
+    if (g->mesh.getVertexCount()) {
+        window->draw(g->mesh);
     }
 
     lim = g->hud.size();
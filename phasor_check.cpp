@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "Phasor.hpp"
+#include "Phase.hpp"
+
+// Accuracy check of the phasor recurrence: fills a long trace in the chunks
+// the graph asks for and compares every sample with the closed form
+// Xmax cos(omega t + phi), its phase taken from the exact fixed-point
+// accumulator. Exits non-zero if the error ever exceeds the tolerance.
+//
+//   phasor_check [steps] [omega] [dt]
+
+#define CHECK_CHUNK 4093        // odd, so blocks are left partly consumed
+#define CHECK_TOLERANCE 1e-6    // of the amplitude
+
+int main(int argc, char** argv) {
+    long long steps = argc > 1 ? atoll(argv[1]) : 100000000LL;
+    double omega = argc > 2 ? atof(argv[2]) : 2 * M_PI;
+    double dt = argc > 3 ? atof(argv[3]) : 1.0 / 1000;
+    double phi = 0.3;
+    if (steps <= 0 || !(dt > 0)) {
+        fprintf(stderr, "usage: phasor_check [steps] [omega] [dt]\n");
+        return 2;
+    }
+
+    struct PhaseAccumulator phase;
+    initPhase(&phase, omega, phi);
+    Tick step = ticksFromSeconds(dt);
+    dt = secondsFromTicks(step);
+
+    struct Phasor p;
+    initPhasor(&p, 1, omega, phi, dt);
+
+    std::vector<float> out(CHECK_CHUNK);
+    double worst = 0;
+    long long worstStep = 0;
+    for (long long i = 0; i < steps; i += CHECK_CHUNK) {
+        int n = steps - i < CHECK_CHUNK ? steps - i : CHECK_CHUNK;
+        phasorFill(&p, out.data(), n);
+        for (int j = 0; j < n; j++) {
+            double x = cos(phaseAt(&phase, (i + j) * step));
+            double error = fabs(out[j] - x);
+            if (error > worst) {
+                worst = error;
+                worstStep = i + j;
+            }
+        }
+    }
+
+    printf("%lld steps of %g s at %g rad/s: max error %.3g at step %lld\n",
+        steps, dt, omega, worst, worstStep);
+    return worst > CHECK_TOLERANCE;
+}